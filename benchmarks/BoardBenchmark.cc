@@ -3,12 +3,46 @@
 #include "../player/Common.h"
 
 #include "../player/Board.h"
+#include "../player/CombinationIndex.h"
+#include "../player/RandomNumberGenerator.h"
 
 namespace
 {
 const std::string layout(
     "01000000100000200001010012110001100000100100001010000000000100011010100010"
     "01000010000000000000100000101011001010" );
+
+std::vector< uint64_t >
+get_random_bitmasks( )
+{
+    std::vector< uint64_t > bitmasks;
+    std::mt19937_64 engine{};
+    while ( bitmasks.size( ) < 4096 )
+    {
+        uint64_t bitmask = 0ull;
+        while ( __builtin_popcountll( bitmask ) < 4 )
+        {
+            bitmask |= 1ull << ( engine( ) & 0x3f );
+        }
+
+        bitmasks.push_back( bitmask );
+    }
+
+    return bitmasks;
+}
+
+void
+run_combination_index( benchmark::State& state, CombinationIndex::Function function )
+{
+    CombinationIndex::init_data( );
+    const auto bitmasks = get_random_bitmasks( );
+
+    size_t i = 0;
+    while ( state.KeepRunning( ) )
+    {
+        benchmark::DoNotOptimize( function( bitmasks[ i++ & 4095 ] ) );
+    }
+}
 }
 
 class BoardBenchmark : public benchmark::Fixture
@@ -20,8 +54,20 @@ class BoardBenchmark : public benchmark::Fixture
     }
 };
 
-BENCHMARK_F( BoardBenchmark, init_data )( benchmark::State& state )
+//! Each iteration builds the context of walls one wall away from the layout, and releases it
+BENCHMARK_F( BoardBenchmark, init_context )( benchmark::State& state )
+{
+    auto walls = layout;
+    walls[ 0 ] = layout[ 0 ] == '0' ? '1' : '0';
+    while ( state.KeepRunning( ) )
+    {
+        Board::release_context( Board::init_context( walls ) );
+    }
+}
+
+BENCHMARK_F( BoardBenchmark, find_context )( benchmark::State& state )
 {
+    Board::init_data( layout );
     while ( state.KeepRunning( ) )
     {
         Board::init_data( layout );
@@ -45,9 +91,112 @@ BENCHMARK_F( BoardBenchmark, get_random_move )( benchmark::State& state )
     Board::init_data( layout );
     Board::pre_compute( );
 
+    RandomNumberGenerator random;
+    Board board;
+    while ( state.KeepRunning( ) )
+    {
+        board.get_random_move( random );
+    }
+}
+
+BENCHMARK_F( BoardBenchmark, combination_index_ffs )( benchmark::State& state )
+{
+    run_combination_index( state, CombinationIndex::get_with_ffs );
+}
+
+BENCHMARK_F( BoardBenchmark, combination_index_bytes )( benchmark::State& state )
+{
+    run_combination_index( state, CombinationIndex::get_with_bytes );
+}
+
+BENCHMARK_F( BoardBenchmark, combination_index_bmi2 )( benchmark::State& state )
+{
+    if ( not CombinationIndex::has_bmi2( ) )
+    {
+        state.SkipWithError( "bmi2 is not supported" );
+    }
+
+    run_combination_index( state, CombinationIndex::get_with_bmi2 );
+}
+
+BENCHMARK_F( BoardBenchmark, random_game )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    Board board;
+    while ( state.KeepRunning( ) )
+    {
+        const auto move = board.get_random_move( random );
+        if ( move == INVALID_MOVE or board.end_game( ) )
+        {
+            board = Board( );
+            continue;
+        }
+
+        board.do_move( move );
+    }
+}
+
+BENCHMARK_F( BoardBenchmark, is_running )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    Board board;
+    while ( board.get_turns( ) < 40 )
+    {
+        board.do_move( board.get_random_move( random ) );
+    }
+
+    while ( state.KeepRunning( ) )
+    {
+        benchmark::DoNotOptimize( board.is_running( ) );
+    }
+}
+
+BENCHMARK_F( BoardBenchmark, random_game_specialized )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
     Board board;
     while ( state.KeepRunning( ) )
     {
-        board.get_random_move( );
+        if ( board.end_game( ) or board.do_random_move( random ) == INVALID_MOVE )
+        {
+            board = Board( );
+        }
+    }
+}
+
+BENCHMARK_F( BoardBenchmark, move_iterator )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    std::vector< Board > boards;
+    for ( Board board; not board.end_game( ) and boards.size( ) < 256; )
+    {
+        boards.push_back( board );
+        const auto move = board.get_random_move( random );
+        if ( move == INVALID_MOVE )
+        {
+            board = Board( );
+            continue;
+        }
+
+        board.do_move( move );
+    }
+
+    size_t i = 0;
+    while ( state.KeepRunning( ) )
+    {
+        auto iterator = boards[ i++ % boards.size( ) ].begin( );
+        benchmark::DoNotOptimize( iterator.move( ) );
     }
 }
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include "../player/Common.h"
+
+#include "../player/Board.h"
+#include "../player/PlayoutBatch.h"
+#include "../player/PlayoutScheduler.h"
+#include "../player/RandomNumberGenerator.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+//! Same horizon as the MCTS simulations started from the first turn
+const int32_t max_turns = 16;
+}
+
+class PlayoutBenchmark : public benchmark::Fixture
+{
+    void
+    SetUp( benchmark::State& state ) override
+    {
+        benchmark::Fixture::SetUp( state );
+    }
+};
+
+BENCHMARK_F( PlayoutBenchmark, scalar )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    int64_t playouts = 0;
+    while ( state.KeepRunning( ) )
+    {
+        Board board;
+        while ( board.get_turns( ) < max_turns and not board.is_running( ) )
+        {
+            const auto move = board.get_random_move( random );
+            if ( move == INVALID_MOVE )
+            {
+                break;
+            }
+
+            board.do_move( move );
+        }
+
+        benchmark::DoNotOptimize( board.get_score( Board::YELLOW ) );
+        ++playouts;
+    }
+
+    state.SetItemsProcessed( playouts );
+}
+
+BENCHMARK_DEFINE_F( PlayoutBenchmark, batched )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    const int32_t lanes = state.range( 0 );
+    std::vector< Board > boards( lanes );
+    std::vector< double > scores( lanes );
+    RandomNumberGenerator random;
+    PlayoutBatch batch( random, Board::YELLOW );
+
+    int64_t playouts = 0;
+    while ( state.KeepRunning( ) )
+    {
+        std::fill( boards.begin( ), boards.end( ), Board( ) );
+        batch.run( boards.data( ), lanes, max_turns, scores.data( ) );
+        benchmark::DoNotOptimize( scores.data( ) );
+        playouts += lanes;
+    }
+
+    state.SetItemsProcessed( playouts );
+}
+
+BENCHMARK_REGISTER_F( PlayoutBenchmark, batched )->Arg( 1 )->Arg( 4 )->Arg( 8 )->Arg( 16 );
+
+BENCHMARK_DEFINE_F( PlayoutBenchmark, interleaved )( benchmark::State& state )
+{
+    Board::init_data( layout );
+    Board::pre_compute( );
+
+    const int32_t count = 64;
+    std::vector< Board > boards( count );
+    std::vector< double > scores( count );
+    RandomNumberGenerator random;
+    PlayoutScheduler scheduler( random, Board::YELLOW, state.range( 0 ) );
+
+    int64_t playouts = 0;
+    while ( state.KeepRunning( ) )
+    {
+        std::fill( boards.begin( ), boards.end( ), Board( ) );
+        scheduler.run( boards.data( ), count, max_turns, scores.data( ) );
+        benchmark::DoNotOptimize( scores.data( ) );
+        playouts += count;
+    }
+
+    state.SetItemsProcessed( playouts );
+}
+
+BENCHMARK_REGISTER_F( PlayoutBenchmark, interleaved )->Arg( 1 )->Arg( 8 )->Arg( 16 );
@@ -4,6 +4,7 @@
 
 #include "../player/Board.h"
 #include "../player/RunStrategy.h"
+#include "../player/SearchContext.h"
 
 namespace
 {
@@ -27,10 +28,11 @@ BENCHMARK_F( RunStrategyBenchmark, get_best_moves )( benchmark::State& state )
     Board::pre_compute( );
     Board board;
     board.enable_solo_mode( Board::YELLOW );
-    RunStrategy run_strategy{};
+    SearchContext search;
+    RunStrategy run_strategy( search );
     while ( state.KeepRunning( ) )
     {
-        const auto best_moves = run_strategy.get_best_action( board );
+        const auto best_moves = run_strategy.get_best_run( board );
         (void)best_moves;
     }
 }
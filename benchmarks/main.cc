@@ -1,3 +1,3 @@
 #include <benchmark/benchmark.h>
 
-BENCHMARK_MAIN( )
+BENCHMARK_MAIN( );
@@ -1,140 +1,189 @@
 #include "Common.h"
 
 #include "Board.h"
+#include "CombinationIndex.h"
 #include "RandomNumberGenerator.h"
+#include "ThreadPool.h"
 #include "Timer.h"
 
+#if defined( __x86_64__ )
+#include <immintrin.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace
 {
 const int32_t MAX_TURNS = 80;
 
 const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
 
-const uint64_t starts[ 4 ] = {1ull << 48 | 1ull << 49 | 1ull << 56 | 1ull << 57,
-                              1ull << 0 | 1ull << 1 | 1ull << 8 | 1ull << 9,
-                              1ull << 54 | 1ull << 55 | 1ull << 62 | 1ull << 63,
-                              1ull << 6 | 1ull << 7 | 1ull << 14 | 1ull << 15};
+constexpr uint64_t starts[ 4 ] = {1ull << 48 | 1ull << 49 | 1ull << 56 | 1ull << 57,
+                                  1ull << 0 | 1ull << 1 | 1ull << 8 | 1ull << 9,
+                                  1ull << 54 | 1ull << 55 | 1ull << 62 | 1ull << 63,
+                                  1ull << 6 | 1ull << 7 | 1ull << 14 | 1ull << 15};
+
+constexpr uint64_t targets[ 4 ] = {starts[ 3 ], starts[ 2 ], starts[ 1 ], starts[ 0 ]};
+
+constexpr int32_t corners[ 4 ] = {7, 63, 0, 56};
+
+//! Compile time lookups of the tables above for the specialized hot paths
+template < Board::Player PLAYER >
+struct PlayerTraits
+{
+    static constexpr Board::Player
+    teammate( )
+    {
+        return static_cast< Board::Player >( ( PLAYER + 2 ) & 3 );
+    }
+
+    static constexpr Board::Player
+    next( )
+    {
+        return static_cast< Board::Player >( ( PLAYER + 1 ) & 3 );
+    }
 
-const uint64_t targets[ 4 ] = {starts[ 3 ], starts[ 2 ], starts[ 1 ], starts[ 0 ]};
+    static constexpr uint64_t
+    target( )
+    {
+        return targets[ PLAYER ];
+    }
+
+    static constexpr int32_t
+    corner( )
+    {
+        return corners[ PLAYER ];
+    }
+
+    //! m_score is the score of the first team
+    static constexpr int32_t
+    score_sign( )
+    {
+        return PLAYER == Board::BLACK or PLAYER == Board::RED ? 1 : -1;
+    }
+};
 
 const int32_t all_fields[ NXN ]
     = {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
        22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
        44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63};
 
-int32_t horizontal_wall_count[ NXN ];
-int32_t vertical_wall_count[ NXN ];
-int32_t count_moves[ NXN ][ 8 ];
-int32_t move_count[ 4096 ];
-
 constexpr int32_t MAX_BITMASKS = 635376;
-constexpr int MAX_NEIGHBORS = 24 * MAX_BITMASKS;
-
-Board::Neighbor computed_neighbors[ MAX_NEIGHBORS ];
-Board::Neighbor* computed_neighbor = computed_neighbors;
-
-const int32_t c[ 65 ][ 5 ] = {{0, 0, 0, 0, 0},
-                              {1, 0, 0, 0, 0},
-                              {1, 1, 0, 0, 0},
-                              {1, 2, 1, 0, 0},
-                              {1, 3, 3, 1, 0},
-                              {1, 4, 6, 4, 1},
-                              {1, 5, 10, 10, 5},
-                              {1, 6, 15, 20, 15},
-                              {1, 7, 21, 35, 35},
-                              {1, 8, 28, 56, 70},
-                              {1, 9, 36, 84, 126},
-                              {1, 10, 45, 120, 210},
-                              {1, 11, 55, 165, 330},
-                              {1, 12, 66, 220, 495},
-                              {1, 13, 78, 286, 715},
-                              {1, 14, 91, 364, 1001},
-                              {1, 15, 105, 455, 1365},
-                              {1, 16, 120, 560, 1820},
-                              {1, 17, 136, 680, 2380},
-                              {1, 18, 153, 816, 3060},
-                              {1, 19, 171, 969, 3876},
-                              {1, 20, 190, 1140, 4845},
-                              {1, 21, 210, 1330, 5985},
-                              {1, 22, 231, 1540, 7315},
-                              {1, 23, 253, 1771, 8855},
-                              {1, 24, 276, 2024, 10626},
-                              {1, 25, 300, 2300, 12650},
-                              {1, 26, 325, 2600, 14950},
-                              {1, 27, 351, 2925, 17550},
-                              {1, 28, 378, 3276, 20475},
-                              {1, 29, 406, 3654, 23751},
-                              {1, 30, 435, 4060, 27405},
-                              {1, 31, 465, 4495, 31465},
-                              {1, 32, 496, 4960, 35960},
-                              {1, 33, 528, 5456, 40920},
-                              {1, 34, 561, 5984, 46376},
-                              {1, 35, 595, 6545, 52360},
-                              {1, 36, 630, 7140, 58905},
-                              {1, 37, 666, 7770, 66045},
-                              {1, 38, 703, 8436, 73815},
-                              {1, 39, 741, 9139, 82251},
-                              {1, 40, 780, 9880, 91390},
-                              {1, 41, 820, 10660, 101270},
-                              {1, 42, 861, 11480, 111930},
-                              {1, 43, 903, 12341, 123410},
-                              {1, 44, 946, 13244, 135751},
-                              {1, 45, 990, 14190, 148995},
-                              {1, 46, 1035, 15180, 163185},
-                              {1, 47, 1081, 16215, 178365},
-                              {1, 48, 1128, 17296, 194580},
-                              {1, 49, 1176, 18424, 211876},
-                              {1, 50, 1225, 19600, 230300},
-                              {1, 51, 1275, 20825, 249900},
-                              {1, 52, 1326, 22100, 270725},
-                              {1, 53, 1378, 23426, 292825},
-                              {1, 54, 1431, 24804, 316251},
-                              {1, 55, 1485, 26235, 341055},
-                              {1, 56, 1540, 27720, 367290},
-                              {1, 57, 1596, 29260, 395010},
-                              {1, 58, 1653, 30856, 424270},
-                              {1, 59, 1711, 32509, 455126},
-                              {1, 60, 1770, 34220, 487635},
-                              {1, 61, 1830, 35990, 521855},
-                              {1, 62, 1891, 37820, 557845},
-                              {1, 63, 1953, 39711, 595665}};
+
+//! The same moves split in arrays, so the occupancy tests of a field run in SIMD lanes.
+//! Missing moves cost more than any remaining moves and are always filtered out.
+struct alignas( 32 ) FieldCandidates
+{
+    uint64_t to[ 8 ];
+    //! Bit of the jumped field, 0 for simple moves so that the test always passes
+    uint64_t middle[ 8 ];
+    int64_t count[ 8 ];
+    Move moves[ 8 ];
+};
+
+//! Bit k is set when the k-th candidate of the field can be played
+uint32_t
+filter_candidates_scalar( const FieldCandidates& candidates,
+                          const uint64_t filled,
+                          const int64_t remaining_moves )
+{
+    uint32_t keep = 0u;
+    for ( int32_t k = 0; k < 8; ++k )
+    {
+        const bool free = ( filled & candidates.to[ k ] ) == 0ull;
+        const bool jumps = ( filled & candidates.middle[ k ] ) == candidates.middle[ k ];
+        const bool affordable = candidates.count[ k ] <= remaining_moves;
+        keep |= static_cast< uint32_t >( free & jumps & affordable ) << k;
+    }
+
+    return keep;
+}
+
+#if defined( __x86_64__ )
+__attribute__( ( target( "avx2" ) ) ) uint32_t
+filter_candidates_avx2( const FieldCandidates& candidates,
+                        const uint64_t filled,
+                        const int64_t remaining_moves )
+{
+    const __m256i filled_lanes = _mm256_set1_epi64x( filled );
+    const __m256i remaining_lanes = _mm256_set1_epi64x( remaining_moves );
+
+    uint32_t keep = 0u;
+    for ( int32_t half = 0; half < 2; ++half )
+    {
+        const __m256i to
+            = _mm256_load_si256( reinterpret_cast< const __m256i* >( candidates.to + 4 * half ) );
+        const __m256i middle = _mm256_load_si256(
+            reinterpret_cast< const __m256i* >( candidates.middle + 4 * half ) );
+        const __m256i count = _mm256_load_si256(
+            reinterpret_cast< const __m256i* >( candidates.count + 4 * half ) );
+
+        const __m256i free
+            = _mm256_cmpeq_epi64( _mm256_and_si256( filled_lanes, to ), _mm256_setzero_si256( ) );
+        const __m256i jumps
+            = _mm256_cmpeq_epi64( _mm256_and_si256( filled_lanes, middle ), middle );
+        const __m256i expensive = _mm256_cmpgt_epi64( count, remaining_lanes );
+        const __m256i kept = _mm256_andnot_si256( expensive, _mm256_and_si256( free, jumps ) );
+
+        keep |= static_cast< uint32_t >( _mm256_movemask_pd( _mm256_castsi256_pd( kept ) ) )
+                << ( 4 * half );
+    }
+
+    return keep;
+}
+#endif
+
+using FilterFunction = uint32_t ( * )( const FieldCandidates& candidates,
+                                       const uint64_t filled,
+                                       const int64_t remaining_moves );
+
+FilterFunction filter_candidates = filter_candidates_scalar;
 
 struct Store
 {
 public:
+    //! Left zero, the searches reset the column of their player, so a private Store is never
+    //! touched when the tables are shared
     struct Node
     {
-        Node( )
-            : moves{-1, -1, -1, -1}
-            , neighbor( nullptr )
-        {
-        }
-
         int8_t moves[ 4 ];
-        Board::Neighbor* neighbor;
     };
 
-    Node& operator[]( uint64_t bitmask )
-    {
-        uint64_t b = bitmask;
-        int32_t index = 0;
-        int32_t d = 1;
-        int32_t last = 0;
-        for ( int32_t l = 0; l < 4; ++l )
-        {
-            int32_t a = __builtin_ffsll( b );
-            index += c[ last + a ][ d++ ];
-            b >>= a;
-            last += a;
-        }
+    Node nodes[ MAX_BITMASKS ];
+};
+
+static_assert( sizeof( Store::Node ) == 4, "Store entries should be packed in 4 bytes" );
+
+//! Estimated moves are at most 127, entries below this distance are all final
+const int32_t MAX_DISTANCE = 128;
 
-        return nodes[ index ];
+//! Resumable Dial search of the estimated moves of one player. The moves cost 1 to 3, so 4
+//! circular buckets of Store indexes hold the whole frontier and every bitmask is expanded
+//! once, at its final distance. Entries not farther than the current bucket are final.
+struct Frontier
+{
+    Frontier( )
+        : player( Board::YELLOW )
+        , distance( 0 )
+        , pending( 0 )
+    {
     }
 
-    Node nodes[ MAX_BITMASKS ];
-};
+    void seed( GameContext& context, const Board::Player seeded_player );
+    //! Expands the current bucket, returns false once the search is exhausted
+    bool expand( GameContext& context );
 
-Store stored;
+    Board::Player player;
+    std::vector< int32_t > buckets[ 4 ];
+    int32_t distance;
+    int32_t pending;
+};
 
 struct ZobristData
 {
@@ -143,14 +192,434 @@ struct ZobristData
     uint32_t remaining_moves[ 4 ];
     uint32_t moves[ 4 ][ 100 ];
     uint32_t fields[ 4 ][ NXN ];
-} hash_data, lock_data;
+};
+
+static_assert( sizeof( Board ) == 64, "Board should fit in a cache line" );
+
+const uint32_t ALL_PLAYERS = 0xfu;
+
+//! State of the background computation of the estimated moves tables
+struct PreCompute
+{
+    //! Complete tables are never computed again, lazy ones may still be completed
+    enum Tables : uint8_t
+    {
+        NONE,
+        LAZY,
+        COMPLETE
+    };
+
+    PreCompute( )
+        : started( ALL_PLAYERS )
+        , finished( ALL_PLAYERS )
+        , priority( 0u )
+        , state( NONE )
+    {
+        for ( auto player = 0; player < 4; ++player )
+        {
+            promises[ player ].set_value( );
+            tables[ player ] = promises[ player ].get_future( ).share( );
+        }
+    }
+
+    //! One pool task per player, each one computes the next table to serve
+    ThreadPool::Group tasks;
+    std::chrono::steady_clock::time_point start;
+    //! Fulfilled once the table of the player is complete
+    std::promise< void > promises[ 4 ];
+    std::shared_future< void > tables[ 4 ];
+    //! Guards the masks of the players whose table is started or finished and of the ones to
+    //! serve first, the futures and the state
+    std::mutex mutex;
+    uint32_t started;
+    uint32_t finished;
+    uint32_t priority;
+    Tables state;
+};
+
+//! Layouts kept by a process, each one holds its own tables; far below what a ContextId indexes
+const int32_t MAX_CONTEXTS = 16;
+}
+
+//! Everything derived from the walls of a layout. It is built once by init_context and shared
+//! by all the boards of the layout; only the estimated moves tables are written afterwards
+struct GameContext
+{
+    explicit GameContext( const std::string& context_walls )
+        : walls( context_walls )
+        , references( 1 )
+        , pinned( false )
+        , private_store( static_cast< Store* >( std::calloc( 1, sizeof( Store ) ) ) )
+        , stored( private_store )
+        , shared_tables( nullptr )
+        , settled_below{0, 0, 0, 0}
+    {
+    }
+
+    ~GameContext( )
+    {
+        std::free( private_store );
+    }
+
+    std::string walls;
+    int32_t horizontal_wall_count[ NXN ];
+    int32_t vertical_wall_count[ NXN ];
+    int32_t count_moves[ NXN ][ 8 ];
+    int32_t move_count[ 4096 ];
+
+    //! Wall-legal moves of a stone standing on a field, the last one is an invalid sentinel.
+    //! Blocking by other stones is checked when the moves are generated.
+    Board::Neighbor field_neighbors[ NXN ][ 9 ];
+    FieldCandidates field_candidates[ NXN ];
+
+    ZobristData hash_data;
+    ZobristData lock_data;
+
+    //! Sessions using the context, guarded by contexts_mutex. A pinned context, the default
+    //! one of a process, is never released
+    int32_t references;
+    bool pinned;
+
+    //! calloc leaves the pages untouched until the tables are computed
+    Store* private_store;
+    //! Either the private Store or the one mapped from shared memory
+    Store* stored;
+    //! The mapped segment when the tables are shared
+    void* shared_tables;
+    Frontier frontiers[ 4 ];
+    int32_t settled_below[ 4 ];
+    PreCompute pre_computing;
+};
+
+namespace
+{
+//! The boards refer to the contexts by index, a released context frees its index for the
+//! next layout
+GameContext* contexts[ MAX_CONTEXTS ];
+//! Guards the registration of the contexts and the one-time initializations
+std::mutex contexts_mutex;
+bool shared_data_ready = false;
+Board::ContextId default_context = 0;
+
+
+void
+Frontier::seed( GameContext& context, const Board::Player seeded_player )
+{
+    player = seeded_player;
+    for ( auto& node : context.stored->nodes )
+    {
+        node.moves[ player ] = -1;
+    }
+
+    for ( auto& bucket : buckets )
+    {
+        bucket.clear( );
+    }
+
+    const int32_t target_index = CombinationIndex::get( targets[ player ] );
+    context.stored->nodes[ target_index ].moves[ player ] = 0;
+    buckets[ 0 ].push_back( target_index );
+
+    distance = 0;
+    pending = 1;
+    context.settled_below[ player ] = 1;
+}
+
+bool
+Frontier::expand( GameContext& context )
+{
+    if ( pending == 0 )
+    {
+        return false;
+    }
+
+    //! Locals, the int8_t stores into the Store could alias the members
+    const Board::Player p = player;
+    const int32_t d = distance;
+    Store::Node* nodes = context.stored->nodes;
+    int32_t added = 0;
+    auto& bucket = buckets[ d & 3 ];
+
+    for ( size_t i = 0; i < bucket.size( ); ++i )
+    {
+        const int32_t index = bucket[ i ];
+        if ( i + 8 < bucket.size( ) )
+        {
+            CombinationIndex::prefetch( bucket[ i + 8 ] );
+            __builtin_prefetch( &nodes[ bucket[ i + 8 ] ] );
+        }
+
+        //! Stale entry, the bitmask was reached again with a shorter distance
+        if ( nodes[ index ].moves[ p ] != d )
+        {
+            continue;
+        }
+
+        const uint64_t top = CombinationIndex::get_bitmask( index );
+        for ( uint64_t stones = top; stones != 0ull; stones &= stones - 1 )
+        {
+            const uint64_t from = stones & -stones;
+            const auto& candidates = context.field_candidates[ __builtin_ctzll( stones ) ];
+
+            //! Alone on the board a stone can only jump over its own stones
+            for ( uint32_t keep = filter_candidates( candidates, top, 3 ); keep != 0u;
+                  keep &= keep - 1 )
+            {
+                const int32_t k = __builtin_ctz( keep );
+                const int32_t proposed_count = d + candidates.count[ k ];
+                const int32_t neighbor_index
+                    = CombinationIndex::get( top ^ from ^ candidates.to[ k ] );
+                int8_t& d_neighbor = nodes[ neighbor_index ].moves[ p ];
+
+                if ( d_neighbor == -1 or d_neighbor > proposed_count )
+                {
+                    d_neighbor = proposed_count;
+                    buckets[ proposed_count & 3 ].push_back( neighbor_index );
+                    ++added;
+                }
+            }
+        }
+    }
+
+    pending += added - static_cast< int32_t >( bucket.size( ) );
+    bucket.clear( );
+    distance = d + 1;
+    context.settled_below[ p ] = pending == 0 ? MAX_DISTANCE : distance + 1;
+
+    return true;
+}
+
+//! Resumes the search of the player until the entry is final
+int8_t
+materialize( GameContext& context, const int32_t index, const Board::Player player )
+{
+    for ( ;; )
+    {
+        const int8_t moves = context.stored->nodes[ index ].moves[ player ];
+        if ( ( moves >= 0 and moves < context.settled_below[ player ] )
+             or not context.frontiers[ player ].expand( context ) )
+        {
+            return moves;
+        }
+    }
+}
+
+//! Estimated moves of a player from a Store entry, the only way the hot paths read them
+inline int8_t
+get_stored_moves( const GameContext& context, const int32_t index, const Board::Player player )
+{
+    const int8_t moves = context.stored->nodes[ index ].moves[ player ];
+    if ( moves >= 0 and moves < context.settled_below[ player ] )
+    {
+        return moves;
+    }
+
+    //! Only lazy tables get here, a single thread uses their context
+    return materialize( const_cast< GameContext& >( context ), index, player );
+}
+
+//! Runs in a pool task, the time is logged but not added to the search time. The tables are
+//! independent, each player only writes its own byte of the Store entries
+void
+compute_next_table( GameContext* context, const Board::ContextId context_id )
+{
+    auto& pre_computing = context->pre_computing;
+
+    Board::Player player;
+    {
+        std::lock_guard< std::mutex > lock( pre_computing.mutex );
+        const uint32_t remaining = ALL_PLAYERS & ~pre_computing.started;
+        const uint32_t preferred = remaining & pre_computing.priority;
+        player = static_cast< Board::Player >(
+            __builtin_ctz( preferred != 0u ? preferred : remaining ) );
+        pre_computing.started |= 1u << player;
+    }
+
+    Board::compute_estimated_moves( player, context_id );
+    pre_computing.promises[ player ].set_value( );
+
+    std::lock_guard< std::mutex > lock( pre_computing.mutex );
+    pre_computing.finished |= 1u << player;
+    if ( pre_computing.finished == ALL_PLAYERS )
+    {
+        const std::chrono::duration< double > delta_time
+            = std::chrono::steady_clock::now( ) - pre_computing.start;
+        std::cerr << "Computing estimated moves time = " << delta_time.count( ) << " sec\n";
+    }
+}
+
+//! Bumped whenever the layout of the estimated moves tables changes
+const uint32_t SHARED_TABLES_VERSION = 2u;
+const uint32_t SHARED_TABLES_MAGIC = 0x4c455353u;
+const int32_t MAX_WALLS_LENGTH = 128;
+//! Time given to the process building the tables before falling back to private tables
+const int32_t SHARED_TABLES_TIMEOUT = 10000000;
+//! One session of the process shares the tables at a time, the others then find them complete
+std::mutex sharing_mutex;
+
+//! Segment shared by the processes playing on the same walls, the header is checked before
+//! the tables are used
+struct SharedTables
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t walls_hash;
+    char walls[ MAX_WALLS_LENGTH ];
+    //! Written right after the mapping, the attaching processes give up when it is gone
+    std::atomic< pid_t > builder;
+    //! Set by the building process once the tables are complete
+    std::atomic< uint32_t > ready;
+    alignas( 64 ) Store store;
+};
+
+uint64_t
+get_walls_hash( const std::string& walls )
+{
+    uint64_t hash = 1469598103934665603ull;
+    for ( const auto c : walls )
+    {
+        hash = ( hash ^ static_cast< uint8_t >( c ) ) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+std::string
+get_shared_tables_name( const uint64_t walls_hash )
+{
+    std::ostringstream name;
+    name << "/less-tables-v" << SHARED_TABLES_VERSION << "-" << std::hex << walls_hash;
+
+    return name.str( );
+}
+
+bool
+build_shared_tables( const int fd, const Board::ContextId context_id, const uint64_t walls_hash )
+{
+    auto context = contexts[ context_id ];
+    const auto& walls = context->walls;
+    if ( ftruncate( fd, sizeof( SharedTables ) ) != 0 )
+    {
+        return false;
+    }
+
+    void* address
+        = mmap( nullptr, sizeof( SharedTables ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if ( address == MAP_FAILED )
+    {
+        return false;
+    }
+
+    auto tables = static_cast< SharedTables* >( address );
+    context->shared_tables = address;
+    tables->builder.store( getpid( ), std::memory_order_release );
+    tables->magic = SHARED_TABLES_MAGIC;
+    tables->version = SHARED_TABLES_VERSION;
+    tables->walls_hash = walls_hash;
+    std::copy( walls.begin( ), walls.end( ), tables->walls );
+
+    context->stored = &tables->store;
+    Board::pre_compute( context_id );
+
+    tables->ready.store( 1u, std::memory_order_release );
+    //! From now on the tables are only read, as in the attached processes
+    mprotect( address, sizeof( SharedTables ), PROT_READ );
+
+    return true;
+}
+
+bool
+is_builder_gone( const SharedTables& tables )
+{
+    const pid_t builder = tables.builder.load( std::memory_order_acquire );
+    return builder != 0 and kill( builder, 0 ) != 0 and errno == ESRCH;
+}
+
+//! A segment whose builder died is removed, so that the next process builds it again
+bool
+attach_shared_tables( const int fd,
+                      GameContext* context,
+                      const uint64_t walls_hash,
+                      const std::string& name )
+{
+    const auto& walls = context->walls;
+    Timer timer;
+    timer.set_alarm( SHARED_TABLES_TIMEOUT );
+
+    //! The building process may not have sized the segment yet
+    struct stat status;
+    while ( fstat( fd, &status ) == 0 and status.st_size < (off_t)sizeof( SharedTables ) )
+    {
+        if ( timer.is_time_over( ) )
+        {
+            //! The builder sizes the segment first thing, it died before that
+            shm_unlink( name.c_str( ) );
+            return false;
+        }
+
+        usleep( 1000 );
+    }
+
+    if ( status.st_size != (off_t)sizeof( SharedTables ) )
+    {
+        return false;
+    }
+
+    void* address = mmap( nullptr, sizeof( SharedTables ), PROT_READ, MAP_SHARED, fd, 0 );
+    if ( address == MAP_FAILED )
+    {
+        return false;
+    }
+
+    const auto tables = static_cast< SharedTables* >( address );
+    while ( tables->ready.load( std::memory_order_acquire ) == 0u )
+    {
+        if ( is_builder_gone( *tables ) )
+        {
+            std::cerr << "Shared tables " << name << " left by a dead builder\n";
+            shm_unlink( name.c_str( ) );
+            munmap( address, sizeof( SharedTables ) );
+            return false;
+        }
+
+        if ( timer.is_time_over( ) )
+        {
+            munmap( address, sizeof( SharedTables ) );
+            return false;
+        }
+
+        usleep( 1000 );
+    }
+
+    if ( tables->magic != SHARED_TABLES_MAGIC or tables->version != SHARED_TABLES_VERSION
+         or tables->walls_hash != walls_hash
+         or walls.compare( 0, std::string::npos, tables->walls, walls.size( ) ) != 0 )
+    {
+        munmap( address, sizeof( SharedTables ) );
+        return false;
+    }
+
+    context->stored = const_cast< Store* >( &tables->store );
+    context->shared_tables = address;
+    //! The builder settled every entry, the reads never resume a search
+    for ( const auto player : players )
+    {
+        context->settled_below[ player ] = MAX_DISTANCE;
+    }
+
+    //! The wait counts as initialization time, as pre_compute does
+    timer.stop( );
+
+    return true;
+}
 
 const Board::Player first_team[ 2 ] = {Board::YELLOW, Board::WHITE};
 const Board::Player second_team[ 2 ] = {Board::BLACK, Board::RED};
 
 int32_t
-get_move_count( const Move move )
+get_move_count( const GameContext& context, const Move move )
 {
+    const auto& count_moves = context.count_moves;
     const int32_t from = move & 0x3f;
     const int32_t to = ( move >> 6 ) & 0x3f;
     if ( to == from + 1 )
@@ -188,155 +657,262 @@ const std::vector< double > weights = []( ) {
 }( );
 
 uint64_t
-get_neighbor_bitmask( uint64_t bitmask, Board::Neighbor* neighbor )
+get_neighbor_bitmask( uint64_t bitmask, const Board::Neighbor* neighbor )
 {
     return bitmask ^ ( 1ull << neighbor->from ) ^ ( 1ull << neighbor->to );
 }
-}
 
-Board::Neighbor*
-Board::compute_neighbors_for( uint64_t bitmask )
+//! No stone of another player stands in the bounding box of the stones and the target corner
+bool
+is_running_box( const uint64_t bitmask, const int32_t corner, const uint64_t filled )
 {
-    Board::Neighbor* result = computed_neighbor;
-    Board::Neighbor* neighbor = computed_neighbor;
+    //! The rows come from the lowest and highest fields, the columns from the bitmask folded
+    //! on a single row
+    const uint64_t box = bitmask | ( 1ull << corner );
+    const int32_t min_row = __builtin_ctzll( box ) >> 3;
+    const int32_t max_row = ( 63 - __builtin_clzll( box ) ) >> 3;
+
+    uint64_t columns = box;
+    columns |= columns >> 32;
+    columns |= columns >> 16;
+    columns |= columns >> 8;
+    columns &= 0xffull;
+
+    const int32_t min_column = __builtin_ctzll( columns );
+    const int32_t max_column = 63 - __builtin_clzll( columns );
+
+    const uint64_t rows_mask
+        = ( ~0ull << ( N * min_row ) ) & ( ~0ull >> ( N * ( N - 1 - max_row ) ) );
+    const uint64_t row_mask = ( 0xffull << min_column ) & ( 0xffull >> ( N - 1 - max_column ) );
+    const uint64_t columns_mask = row_mask * 0x0101010101010101ull;
+
+    return ( rows_mask & columns_mask & filled & ~bitmask ) == 0ull;
+}
+}
 
-    auto empty = [bitmask]( int32_t f ) { return ( bitmask & ( 1ull << f ) ) == 0; };
+void
+Board::compute_neighbors_for( GameContext& context, const int32_t field )
+{
+    const auto& count_moves = context.count_moves;
+    Board::Neighbor* neighbor = context.field_neighbors[ field ];
 
-    for ( int32_t field : all_fields )
+    if ( count_moves[ field ][ RIGHT_1 ] != OO )
     {
-        if ( ( bitmask & ( 1ull << field ) ) == 0 )
-        {
-            continue;
-        }
+        neighbor->count = count_moves[ field ][ RIGHT_1 ];
+        neighbor->from = field;
+        neighbor->to = field + 1;
+        neighbor->check_middle = 0;
 
-        if ( count_moves[ field ][ RIGHT_1 ] != OO and empty( field + 1 ) )
-        {
-            neighbor->count = count_moves[ field ][ RIGHT_1 ];
-            neighbor->from = field;
-            neighbor->to = field + 1;
-            neighbor->check_middle = 0;
-
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ RIGHT_2 ] != OO and empty( field + 2 ) )
-        {
-            neighbor->count = count_moves[ field ][ RIGHT_2 ];
-            neighbor->from = field;
-            neighbor->to = field + 2;
-            neighbor->check_middle = empty( field + 1 );
+    if ( count_moves[ field ][ RIGHT_2 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ RIGHT_2 ];
+        neighbor->from = field;
+        neighbor->to = field + 2;
+        neighbor->check_middle = 1;
 
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ LEFT_1 ] != OO and empty( field - 1 ) )
-        {
-            neighbor->count = count_moves[ field ][ LEFT_1 ];
-            neighbor->from = field;
-            neighbor->to = field - 1;
-            neighbor->check_middle = 0;
+    if ( count_moves[ field ][ LEFT_1 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ LEFT_1 ];
+        neighbor->from = field;
+        neighbor->to = field - 1;
+        neighbor->check_middle = 0;
 
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ LEFT_2 ] != OO and empty( field - 2 ) )
-        {
-            neighbor->count = count_moves[ field ][ LEFT_2 ];
-            neighbor->from = field;
-            neighbor->to = field - 2;
-            neighbor->check_middle = empty( field - 1 );
+    if ( count_moves[ field ][ LEFT_2 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ LEFT_2 ];
+        neighbor->from = field;
+        neighbor->to = field - 2;
+        neighbor->check_middle = 1;
 
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ UP_1 ] != OO and empty( field - N ) )
-        {
-            neighbor->count = count_moves[ field ][ UP_1 ];
-            neighbor->from = field;
-            neighbor->to = field - N;
-            neighbor->check_middle = 0;
+    if ( count_moves[ field ][ UP_1 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ UP_1 ];
+        neighbor->from = field;
+        neighbor->to = field - N;
+        neighbor->check_middle = 0;
 
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ UP_2 ] != OO and empty( field - 2 * N ) )
-        {
-            neighbor->count = count_moves[ field ][ UP_2 ];
-            neighbor->from = field;
-            neighbor->to = field - 2 * N;
-            neighbor->check_middle = empty( field - N );
+    if ( count_moves[ field ][ UP_2 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ UP_2 ];
+        neighbor->from = field;
+        neighbor->to = field - 2 * N;
+        neighbor->check_middle = 1;
 
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ DOWN_1 ] != OO and empty( field + N ) )
-        {
-            neighbor->count = count_moves[ field ][ DOWN_1 ];
-            neighbor->from = field;
-            neighbor->to = field + N;
-            neighbor->check_middle = 0;
+    if ( count_moves[ field ][ DOWN_1 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ DOWN_1 ];
+        neighbor->from = field;
+        neighbor->to = field + N;
+        neighbor->check_middle = 0;
 
-            ++neighbor;
-        }
+        ++neighbor;
+    }
 
-        if ( count_moves[ field ][ DOWN_2 ] != OO and empty( field + 2 * N ) )
-        {
-            neighbor->count = count_moves[ field ][ DOWN_2 ];
-            neighbor->from = field;
-            neighbor->to = field + 2 * N;
-            neighbor->check_middle = empty( field + N );
+    if ( count_moves[ field ][ DOWN_2 ] != OO )
+    {
+        neighbor->count = count_moves[ field ][ DOWN_2 ];
+        neighbor->from = field;
+        neighbor->to = field + 2 * N;
+        neighbor->check_middle = 1;
 
-            ++neighbor;
-        }
+        ++neighbor;
     }
 
-    computed_neighbor = ++neighbor;
+    *neighbor = Board::Neighbor( );
 
-    return result;
+    auto& candidates = context.field_candidates[ field ];
+    int32_t k = 0;
+    for ( neighbor = context.field_neighbors[ field ]; neighbor->valid( ); ++neighbor, ++k )
+    {
+        candidates.to[ k ] = 1ull << neighbor->to;
+        candidates.middle[ k ] = neighbor->check_middle ? 1ull << neighbor->middle( ) : 0ull;
+        candidates.count[ k ] = neighbor->count;
+        candidates.moves[ k ] = CREATE_MOVE( static_cast< int32_t >( neighbor->from ),
+                                             static_cast< int32_t >( neighbor->to ) );
+    }
+
+    for ( ; k < 8; ++k )
+    {
+        candidates.to[ k ] = 0ull;
+        candidates.middle[ k ] = 0ull;
+        candidates.count[ k ] = 4;
+        candidates.moves[ k ] = INVALID_MOVE;
+    }
 }
 
-Board::Board( )
-    : m_player( YELLOW )
-    , m_teammate( WHITE )
-    , m_player_remaining_moves( 3 )
-    , m_bitmasks{starts[ 0 ], starts[ 1 ], starts[ 2 ], starts[ 3 ]}
-    , m_filled( starts[ 0 ] | starts[ 1 ] | starts[ 2 ] | starts[ 3 ] )
+Board::Board( const ContextId context )
+    : m_bitmasks{starts[ 0 ], starts[ 1 ], starts[ 2 ], starts[ 3 ]}
+    , m_indexes{CombinationIndex::get( starts[ 0 ] ), CombinationIndex::get( starts[ 1 ] ),
+                CombinationIndex::get( starts[ 2 ] ), CombinationIndex::get( starts[ 3 ] )}
     , m_moves{0, 0, 0, 0}
+    , m_estimated_moves{0, 0, 0, 0}
+    , m_score( 0 )
+    , m_player( YELLOW )
+    , m_player_remaining_moves( 3 )
     , m_turns( 0 )
     , m_solo( false )
+    , m_done( 0u )
+    , m_context( context )
 {
+    //! Boards may be built before any context, as the test fixtures are
+    if ( contexts[ m_context ] != nullptr )
+    {
+        update_estimated_moves( );
+    }
 }
 
-Board::Board( const Player player, const uint64_t bitmasks[ 4 ] )
-    : m_player( player )
-    , m_teammate( get_teammate( player ) )
-    , m_player_remaining_moves( 3 )
-    , m_bitmasks{bitmasks[ 0 ], bitmasks[ 1 ], bitmasks[ 2 ], bitmasks[ 3 ]}
-    , m_filled( bitmasks[ 0 ] | bitmasks[ 1 ] | bitmasks[ 2 ] | bitmasks[ 3 ] )
+Board::Board( const Player player, const uint64_t bitmasks[ 4 ], const ContextId context )
+    : m_bitmasks{bitmasks[ 0 ], bitmasks[ 1 ], bitmasks[ 2 ], bitmasks[ 3 ]}
+    , m_indexes{CombinationIndex::get( bitmasks[ 0 ] ), CombinationIndex::get( bitmasks[ 1 ] ),
+                CombinationIndex::get( bitmasks[ 2 ] ), CombinationIndex::get( bitmasks[ 3 ] )}
     , m_moves{0, 0, 0, 0}
+    , m_estimated_moves{0, 0, 0, 0}
+    , m_score( 0 )
+    , m_player( player )
+    , m_player_remaining_moves( 3 )
     , m_turns( 0 )
     , m_solo( false )
+    , m_done( 0u )
+    , m_context( context )
 {
+    update_estimated_moves( );
 }
 
-Board::Board( const Player player, const uint64_t bitmask )
-    : m_player( player )
-    , m_teammate( get_teammate( player ) )
-    , m_player_remaining_moves( 3 )
-    , m_bitmasks{0ull, 0ull, 0ull, 0ull}
+Board::Board( const Player player, const uint64_t bitmask, const ContextId context )
+    : m_bitmasks{0ull, 0ull, 0ull, 0ull}
+    , m_indexes{0, 0, 0, 0}
     , m_moves{0, 0, 0, 0}
+    , m_estimated_moves{0, 0, 0, 0}
+    , m_score( 0 )
+    , m_player( player )
+    , m_player_remaining_moves( 3 )
     , m_turns( 0 )
     , m_solo( true )
+    , m_done( 0u )
+    , m_context( context )
 {
     m_bitmasks[ m_player ] = bitmask;
-    m_filled = bitmask;
+    m_indexes[ m_player ] = CombinationIndex::get( bitmask );
+
+    //! Only the table of the player is needed in solo mode
+    update_estimated_moves( player );
 }
 
-void
+const Board::ContextId Board::NO_CONTEXT;
+
+Board::ContextId
 Board::init_data( const std::string& walls )
 {
+    const auto context = init_context( walls );
+    if ( context == NO_CONTEXT )
+    {
+        std::abort( );
+    }
+
+    std::lock_guard< std::mutex > lock( contexts_mutex );
+    contexts[ context ]->pinned = true;
+    default_context = context;
+
+    return default_context;
+}
+
+Board::ContextId
+Board::init_context( const std::string& walls )
+{
+    std::lock_guard< std::mutex > lock( contexts_mutex );
+    int32_t free_id = NO_CONTEXT;
+    for ( int32_t id = MAX_CONTEXTS - 1; id >= 0; --id )
+    {
+        if ( contexts[ id ] == nullptr )
+        {
+            free_id = id;
+        }
+        else if ( contexts[ id ]->walls == walls )
+        {
+            ++contexts[ id ]->references;
+            return id;
+        }
+    }
+
+    if ( free_id == NO_CONTEXT )
+    {
+        std::cerr << "No context left for the walls, " << MAX_CONTEXTS << " are in use\n";
+        return NO_CONTEXT;
+    }
+
     Timer timer;
 
+    //! The candidates are loaded with aligned AVX2 loads
+    void* memory = nullptr;
+    if ( posix_memalign( &memory, alignof( GameContext ), sizeof( GameContext ) ) != 0 )
+    {
+        std::cerr << "Context allocation failed\n";
+        std::abort( );
+    }
+
+    auto& context = *new ( memory ) GameContext( walls );
+    auto& vertical_wall_count = context.vertical_wall_count;
+    auto& horizontal_wall_count = context.horizontal_wall_count;
+    auto& count_moves = context.count_moves;
+
     int32_t index = 0;
 
     for ( int32_t i = 0; i < N; ++i )
@@ -439,78 +1015,303 @@ Board::init_data( const std::string& walls )
         }
     }
 
-    for ( ZobristData* zobrist : {&hash_data, &lock_data} )
+    //! Default seeded, the keys only need to be distinct within the process
+    RandomNumberGenerator random;
+    for ( ZobristData* zobrist : {&context.hash_data, &context.lock_data} )
     {
-        zobrist->init = RandomNumberGenerator::pick( );
+        zobrist->init = random.pick( );
 
         for ( auto i = 0; i < 4; ++i )
         {
-            zobrist->remaining_moves[ i ] = RandomNumberGenerator::pick( );
+            zobrist->remaining_moves[ i ] = random.pick( );
         }
 
         for ( auto p : players )
         {
-            zobrist->player[ p ] = RandomNumberGenerator::pick( );
+            zobrist->player[ p ] = random.pick( );
 
             for ( int32_t f : all_fields )
             {
-                zobrist->fields[ p ][ f ] = RandomNumberGenerator::pick( );
+                zobrist->fields[ p ][ f ] = random.pick( );
             }
 
             for ( int32_t m = 0; m < 100; ++m )
             {
-                zobrist->moves[ p ][ m ] = RandomNumberGenerator::pick( );
+                zobrist->moves[ p ][ m ] = random.pick( );
             }
         }
     }
 
     for ( int32_t m = 0; m < 4096; ++m )
     {
-        move_count[ m ] = get_move_count( m );
+        context.move_count[ m ] = get_move_count( context, m );
     }
 
+    for ( int32_t field : all_fields )
+    {
+        compute_neighbors_for( context, field );
+    }
+
+    //! Shared by all the contexts
+    if ( not shared_data_ready )
+    {
+        shared_data_ready = true;
+#if defined( __x86_64__ )
+        if ( __builtin_cpu_supports( "avx2" ) )
+        {
+            filter_candidates = filter_candidates_avx2;
+        }
+#endif
+        std::cerr << "Move filter = "
+                  << ( filter_candidates == filter_candidates_scalar ? "scalar" : "avx2" ) << "\n";
+
+        CombinationIndex::init_data( );
+    }
+
+    contexts[ free_id ] = &context;
+
     timer.stop( );
     std::cerr << "Data init tooks " << timer.get_delta_time( ) << " sec\n";
+
+    return free_id;
+}
+
+bool
+Board::are_valid_walls( const std::string& walls )
+{
+    //! A count for the walls right of the fields of each row, then below those of each row
+    const size_t length = 2 * N * ( N - 1 );
+
+    return walls.size( ) == length
+           and std::all_of( walls.begin( ), walls.end( ),
+                            []( const char c ) { return c >= '0' and c <= '2'; } );
+}
+
+void
+Board::release_context( const ContextId id )
+{
+    std::lock_guard< std::mutex > lock( contexts_mutex );
+    auto context = contexts[ id ];
+    if ( --context->references > 0 or context->pinned )
+    {
+        return;
+    }
+
+    //! The tables tasks still reach the context through its index
+    ThreadPool::get( ).wait( context->pre_computing.tasks );
+    contexts[ id ] = nullptr;
+
+    if ( context->shared_tables != nullptr )
+    {
+        munmap( context->shared_tables, sizeof( SharedTables ) );
+    }
+
+    context->~GameContext( );
+    std::free( context );
+}
+
+Board::ContextId
+Board::get_default_context( )
+{
+    return default_context;
 }
 
 void
-Board::pre_compute( )
+Board::pre_compute( const ContextId context )
 {
     Timer timer;
+    start_pre_compute( context );
+    wait_for_tables( ALL_PLAYERS, context );
+    timer.stop( );
 
-    for ( int a = 0; a < 64; ++a )
+    std::cerr << "Total initialization time = " << timer.get_delta_time( ) << " sec\n";
+}
+
+bool
+Board::share_tables( const ContextId context )
+{
+    const auto& walls = contexts[ context ]->walls;
+    auto& pre_computing = contexts[ context ]->pre_computing;
+    std::lock_guard< std::mutex > sharing_lock( sharing_mutex );
     {
-        for ( int b = a + 1; b < 64; ++b )
+        std::lock_guard< std::mutex > lock( pre_computing.mutex );
+        if ( walls.size( ) >= MAX_WALLS_LENGTH or pre_computing.state != PreCompute::NONE )
         {
-            for ( int c = b + 1; c < 64; ++c )
-            {
-                for ( int d = c + 1; d < 64; ++d )
-                {
-                    uint64_t bitmask = 1ull << a | 1ull << b | 1ull << c | 1ull << d;
-                    stored[ bitmask ].neighbor = compute_neighbors_for( bitmask );
-                }
-            }
+            return false;
         }
     }
 
-    timer.stop( );
-    const double neighbors_delta_time = timer.get_delta_time( );
-    std::cerr << "Computing neighbors time = " << neighbors_delta_time << " sec\n";
-    std::cerr << "Neighbors usage = "
-              << 100 * ( computed_neighbor - computed_neighbors ) / ( 24 * MAX_BITMASKS ) << "%\n";
-    std::cerr << "Neighbors memory = " << sizeof( computed_neighbors ) / 1e6 << "M\n";
+    const uint64_t walls_hash = get_walls_hash( walls );
+    const auto name = get_shared_tables_name( walls_hash );
+
+    bool shared = false;
+    int fd = shm_open( name.c_str( ), O_CREAT | O_EXCL | O_RDWR, 0644 );
+    if ( fd >= 0 )
+    {
+        shared = build_shared_tables( fd, context, walls_hash );
+        if ( not shared )
+        {
+            shm_unlink( name.c_str( ) );
+        }
+        std::cerr << "Shared tables " << name << ( shared ? " built\n" : " not built\n" );
+    }
+    else if ( errno == EEXIST and ( fd = shm_open( name.c_str( ), O_RDONLY, 0 ) ) >= 0 )
+    {
+        shared = attach_shared_tables( fd, contexts[ context ], walls_hash, name );
+        if ( shared )
+        {
+            std::lock_guard< std::mutex > lock( pre_computing.mutex );
+            pre_computing.state = PreCompute::COMPLETE;
+        }
+        std::cerr << "Shared tables " << name << ( shared ? " attached\n" : " not attached\n" );
+    }
+
+    //! The mapping stays valid once the descriptor is closed
+    if ( fd >= 0 )
+    {
+        close( fd );
+    }
+
+    return shared;
+}
+
+void
+Board::unshare_tables( const ContextId context )
+{
+    const auto name = get_shared_tables_name( get_walls_hash( contexts[ context ]->walls ) );
+    shm_unlink( name.c_str( ) );
+}
+
+bool
+Board::has_complete_tables( const ContextId context )
+{
+    auto& pre_computing = contexts[ context ]->pre_computing;
+    std::lock_guard< std::mutex > lock( pre_computing.mutex );
+
+    return pre_computing.state == PreCompute::COMPLETE;
+}
+
+bool
+Board::is_table_settled( const Player player, const ContextId context )
+{
+    return contexts[ context ]->settled_below[ player ] == MAX_DISTANCE;
+}
+
+uint32_t
+Board::filter_field_candidates( const int32_t field,
+                                const uint64_t filled,
+                                const int32_t remaining_moves,
+                                const bool avx2,
+                                const ContextId context )
+{
+    const auto& candidates = contexts[ context ]->field_candidates[ field ];
+#if defined( __x86_64__ )
+    if ( avx2 )
+    {
+        assert( has_avx2_filter( ) );
+        return filter_candidates_avx2( candidates, filled, remaining_moves );
+    }
+#else
+    assert( not avx2 );
+#endif
+
+    return filter_candidates_scalar( candidates, filled, remaining_moves );
+}
+
+bool
+Board::has_avx2_filter( )
+{
+#if defined( __x86_64__ )
+    return __builtin_cpu_supports( "avx2" );
+#else
+    return false;
+#endif
+}
+
+void
+Board::init_lazy_tables( const ContextId context_id )
+{
+    auto& context = *contexts[ context_id ];
+    auto& pre_computing = context.pre_computing;
+    {
+        std::lock_guard< std::mutex > lock( pre_computing.mutex );
+        if ( pre_computing.state == PreCompute::COMPLETE )
+        {
+            return;
+        }
+
+        pre_computing.state = PreCompute::LAZY;
+    }
+
+    for ( const auto player : players )
+    {
+        context.frontiers[ player ].seed( context, player );
+    }
+}
 
-    timer.reset( );
+void
+Board::start_pre_compute( const ContextId context_id )
+{
+    auto context = contexts[ context_id ];
+    auto& pre_computing = context->pre_computing;
+
+    std::lock_guard< std::mutex > lock( pre_computing.mutex );
+    if ( pre_computing.state == PreCompute::COMPLETE )
+    {
+        return;
+    }
+
+    std::cerr << "Neighbors memory = " << sizeof( context->field_neighbors ) / 1e3 << "K\n";
+    std::cerr << "Estimated moves memory = " << sizeof( Store ) / 1e6 << "M\n";
 
     for ( const auto player : players )
     {
-        compute_estimated_moves( player );
+        pre_computing.promises[ player ] = std::promise< void >( );
+        pre_computing.tables[ player ] = pre_computing.promises[ player ].get_future( ).share( );
+    }
+
+    pre_computing.started = 0u;
+    pre_computing.finished = 0u;
+    pre_computing.priority = 0u;
+    pre_computing.state = PreCompute::COMPLETE;
+    pre_computing.start = std::chrono::steady_clock::now( );
+
+    auto& pool = ThreadPool::get( );
+    for ( auto player = 0; player < 4; ++player )
+    {
+        pool.submit( [context, context_id]( ) { compute_next_table( context, context_id ); },
+                     pre_computing.tasks );
+    }
+}
+
+void
+Board::prioritize_tables( const uint32_t players_mask, const ContextId context )
+{
+    auto& pre_computing = contexts[ context ]->pre_computing;
+    std::lock_guard< std::mutex > lock( pre_computing.mutex );
+    pre_computing.priority = players_mask;
+}
+
+void
+Board::wait_for_tables( const uint32_t players_mask, const ContextId context )
+{
+    auto& pre_computing = contexts[ context ]->pre_computing;
+    for ( uint32_t mask = players_mask; mask != 0u; mask &= mask - 1 )
+    {
+        std::shared_future< void > table;
+        {
+            std::lock_guard< std::mutex > lock( pre_computing.mutex );
+            table = pre_computing.tables[ __builtin_ctz( mask ) ];
+        }
+
+        table.wait( );
     }
+}
 
-    timer.stop( );
-    std::cerr << "Computing estimated moves time = " << timer.get_delta_time( ) << " sec\n";
-    std::cerr << "Estimated moves memory = " << sizeof( Store ) / 1e6 << "M\n";
-    std::cerr << "Total initialization time = " << timer.get_total_time( ) << " sec\n";
+uint64_t
+Board::get_start( const Player player )
+{
+    return starts[ player ];
 }
 
 Board::~Board( )
@@ -520,7 +1321,19 @@ Board::~Board( )
 Board::Player
 Board::get_player( ) const
 {
-    return m_player;
+    return static_cast< Player >( m_player );
+}
+
+Board::Player
+Board::get_teammate( ) const
+{
+    return get_teammate( get_player( ) );
+}
+
+uint64_t
+Board::get_filled( ) const
+{
+    return m_bitmasks[ YELLOW ] | m_bitmasks[ BLACK ] | m_bitmasks[ WHITE ] | m_bitmasks[ RED ];
 }
 
 int32_t
@@ -538,8 +1351,9 @@ Board::do_move( const Move move )
         const int32_t to = ( move >> 6 ) & 0x3f;
 
         swap( from, to );
-        count = move_count[ move ];
+        count = contexts[ m_context ]->move_count[ move ];
         m_moves[ m_player ] += count;
+        update_estimated_moves( get_player( ) );
 
         if ( not m_solo )
         {
@@ -554,10 +1368,50 @@ Board::do_move( const Move move )
     return count;
 }
 
+template < Board::Player PLAYER, bool SOLO >
+int32_t
+Board::do_move( const Move move )
+{
+    assert( m_player == PLAYER and m_solo == SOLO );
+
+    if ( move == NIL_MOVE )
+    {
+        next_player< PLAYER >( );
+        return 0;
+    }
+
+    const int32_t from = move & 0x3f;
+    const int32_t to = ( move >> 6 ) & 0x3f;
+
+    if ( not SOLO and is_done( PLAYER ) )
+    {
+        swap< PlayerTraits< PLAYER >::teammate( ) >( from, to );
+    }
+    else
+    {
+        swap< PLAYER >( from, to );
+    }
+
+    const int32_t count = contexts[ m_context ]->move_count[ move ];
+    m_moves[ PLAYER ] += count;
+    update_estimated_moves< PLAYER >( );
+
+    if ( not SOLO )
+    {
+        m_player_remaining_moves -= count;
+        if ( m_player_remaining_moves == 0 )
+        {
+            next_player< PLAYER >( );
+        }
+    }
+
+    return count;
+}
+
 void
 Board::do_action( const Action& action )
 {
-    const auto player = m_player;
+    const auto player = get_player( );
     for ( const auto move : action )
     {
         do_move( move );
@@ -578,23 +1432,24 @@ Board::enable_solo_mode( const Player player )
         if ( p != player )
         {
             m_bitmasks[ p ] = 0ull;
+            m_indexes[ p ] = 0;
         }
     }
 
-    m_filled = m_bitmasks[ player ];
-
     m_player = player;
-    m_teammate = get_teammate( player );
     m_player_remaining_moves = 3;
+    m_done &= 1u << player;
 
     m_solo = true;
+
+    //! Only the table of the player is needed in solo mode
+    update_estimated_moves( player );
 }
 
 bool
 Board::end_game( ) const
 {
-    return ( m_turns == MAX_TURNS )
-           or ( is_done( YELLOW ) and is_done( WHITE ) and is_done( BLACK ) and is_done( RED ) );
+    return ( m_turns == MAX_TURNS ) or ( m_done == 0xfu );
 }
 
 double
@@ -606,30 +1461,59 @@ Board::get_mobility( const Player ) const
 double
 Board::get_estimated_moves( const Player player ) const
 {
-    return m_moves[ player ] + stored[ m_bitmasks[ player ] ].moves[ player ];
+    return m_estimated_moves[ player ];
 }
 
-double
-Board::get_score( const Player player ) const
+void
+Board::update_estimated_moves( const Player player )
 {
-    double score = 0.0;
+    const auto& context = *contexts[ m_context ];
+    const int32_t estimated_moves
+        = m_moves[ player ] + get_stored_moves( context, m_indexes[ player ], player );
+    const int32_t delta = estimated_moves - m_estimated_moves[ player ];
+    m_estimated_moves[ player ] = estimated_moves;
 
-    for ( const auto p : first_team )
+    //! m_score is the score of the first team: the less moves the better
+    m_score += ( player == BLACK or player == RED ) ? delta : -delta;
+
+    if ( m_bitmasks[ player ] == targets[ player ] )
     {
-        score -= get_estimated_moves( p );
+        m_done |= 1u << player;
     }
-
-    for ( const auto p : second_team )
+    else
     {
-        score += get_estimated_moves( p );
+        m_done &= ~( 1u << player );
     }
+}
+
+template < Board::Player PLAYER >
+void
+Board::update_estimated_moves( )
+{
+    const auto& context = *contexts[ m_context ];
+    const int32_t estimated_moves
+        = m_moves[ PLAYER ] + get_stored_moves( context, m_indexes[ PLAYER ], PLAYER );
+    const int32_t delta = estimated_moves - m_estimated_moves[ PLAYER ];
+    m_estimated_moves[ PLAYER ] = estimated_moves;
+    m_score += PlayerTraits< PLAYER >::score_sign( ) * delta;
+
+    const uint16_t done = m_bitmasks[ PLAYER ] == PlayerTraits< PLAYER >::target( );
+    m_done = ( m_done & ~( 1u << PLAYER ) ) | ( done << PLAYER );
+}
 
-    if ( player == BLACK or player == RED )
+void
+Board::update_estimated_moves( )
+{
+    for ( const auto player : players )
     {
-        score = -score;
+        update_estimated_moves( player );
     }
+}
 
-    return score;
+double
+Board::get_score( const Player player ) const
+{
+    return player == BLACK or player == RED ? -m_score : m_score;
 }
 
 double
@@ -651,25 +1535,70 @@ Board::evaluate( const Player player ) const
 }
 
 Board::MoveIterator::MoveIterator( const Board& board )
-    : m_player( board.m_player )
+    : m_context( contexts[ board.m_context ] )
+    , m_player( board.get_player( ) )
     , m_bitmask( board.m_bitmasks[ m_player ] )
+    , m_store_index( board.m_indexes[ m_player ] )
     , m_index( 0 )
     , m_count( 0 )
 {
-    if ( not board.is_done( board.m_player ) )
+    if ( not board.is_done( board.get_player( ) ) )
     {
         push_moves( board );
     }
-    else if ( not board.is_done( board.m_teammate ) )
+    else if ( not board.is_done( board.get_teammate( ) ) )
     {
-        m_player = board.m_teammate;
-        m_bitmask = board.m_bitmasks[ m_player ];
+        set_player( board, board.get_teammate( ) );
         push_moves( board );
     }
 
     try_nil_move( board );
 
-    m_actual_moves = stored[ m_bitmask ].moves[ m_player ];
+    m_actual_moves = get_stored_moves( *m_context, m_store_index, m_player );
+}
+
+template < Board::Player PLAYER, bool SOLO >
+Board::MoveIterator
+Board::MoveIterator::create( const Board& board )
+{
+    constexpr auto TEAMMATE = PlayerTraits< PLAYER >::teammate( );
+
+    MoveIterator iterator;
+    iterator.m_context = contexts[ board.m_context ];
+    iterator.m_index = 0;
+    iterator.m_count = 0;
+
+    const bool done = board.is_done( PLAYER );
+    iterator.set_player( board, not SOLO and done ? TEAMMATE : PLAYER );
+    if ( not done or ( not SOLO and not board.is_done( TEAMMATE ) ) )
+    {
+        iterator.push_moves( board );
+    }
+
+    //! In solo mode the teammate has no stones and is never done
+    if ( board.m_player_remaining_moves < 3
+         or ( not SOLO and done and board.is_done( TEAMMATE ) ) )
+    {
+        auto& data = iterator.m_data[ iterator.m_count ];
+        data.move = NIL_MOVE;
+        data.index = iterator.m_store_index;
+        data.count = board.m_player_remaining_moves;
+
+        ++iterator.m_count;
+    }
+
+    iterator.m_actual_moves
+        = get_stored_moves( *iterator.m_context, iterator.m_store_index, iterator.m_player );
+
+    return iterator;
+}
+
+void
+Board::MoveIterator::set_player( const Board& board, const Player player )
+{
+    m_player = player;
+    m_bitmask = board.m_bitmasks[ player ];
+    m_store_index = board.m_indexes[ player ];
 }
 
 void
@@ -679,7 +1608,7 @@ Board::MoveIterator::try_nil_move( const Board& board )
     {
         auto& data = m_data[ m_count ];
         data.move = NIL_MOVE;
-        data.bitmask = m_bitmask;
+        data.index = m_store_index;
         data.count = board.m_player_remaining_moves;
 
         ++m_count;
@@ -689,32 +1618,30 @@ Board::MoveIterator::try_nil_move( const Board& board )
 void
 Board::MoveIterator::push_moves( const Board& board )
 {
-    for ( auto neighbor = stored[ m_bitmask ].neighbor; neighbor->valid( ); ++neighbor )
-    {
-        if ( neighbor->count > board.m_player_remaining_moves )
-        {
-            continue;
-        }
+    const uint64_t filled = board.get_filled( );
+    const int64_t remaining_moves = board.m_player_remaining_moves;
+    const int32_t first = m_count;
 
-        if ( not board.is_empty( neighbor->to ) )
-        {
-            continue;
-        }
+    for ( uint64_t stones = m_bitmask; stones != 0ull; stones &= stones - 1 )
+    {
+        const auto& candidates = m_context->field_candidates[ __builtin_ctzll( stones ) ];
+        const uint32_t keep = filter_candidates( candidates, filled, remaining_moves );
 
-        if ( neighbor->check_middle and board.is_empty( neighbor->middle( ) ) )
+        //! Every candidate is written, only the kept ones are counted
+        for ( int32_t k = 0; k < 8; ++k )
         {
-            continue;
+            auto& data = m_data[ m_count ];
+            data.move = candidates.moves[ k ];
+            data.count = candidates.count[ k ];
+            m_count += ( keep >> k ) & 1u;
         }
+    }
 
-        auto& data = m_data[ m_count ];
-
-        data.move = CREATE_MOVE( static_cast< int32_t >( neighbor->from ),
-                                 static_cast< int32_t >( neighbor->to ) );
-
-        data.bitmask = get_neighbor_bitmask( m_bitmask, neighbor );
-        data.count = neighbor->count;
-
-        m_count++;
+    for ( int32_t i = first; i < m_count; ++i )
+    {
+        auto& data = m_data[ i ];
+        data.index = CombinationIndex::get_moved( m_store_index, m_bitmask, data.move & 0x3f,
+                                                  ( data.move >> 6 ) & 0x3f );
     }
 }
 
@@ -737,7 +1664,46 @@ int8_t
 Board::MoveIterator::delta_moves( ) const
 {
     auto& data = m_data[ m_index ];
-    return m_actual_moves - stored[ data.bitmask ].moves[ m_player ] - data.count;
+    return m_actual_moves - get_stored_moves( *m_context, data.index, m_player ) - data.count;
+}
+
+void
+Board::MoveIterator::prefetch( ) const
+{
+    for ( int32_t i = m_index; i < m_count; ++i )
+    {
+        __builtin_prefetch( &m_context->stored->nodes[ m_data[ i ].index ] );
+    }
+}
+
+Move
+Board::MoveIterator::random_move( RandomNumberGenerator& random )
+{
+    using WeightMove = std::pair< double, Move >;
+
+    WeightMove weighted_moves[ MAX_MOVES ];
+
+    double sum_weights = 0.0;
+    WeightMove* weighted_moves_end = weighted_moves;
+    for ( ; valid( ); next( ) )
+    {
+        const int32_t index = delta_moves( ) + 6;
+        sum_weights += weights[ index ];
+        weighted_moves_end->first = sum_weights;
+        weighted_moves_end->second = move( );
+        ++weighted_moves_end;
+    }
+
+    if ( weighted_moves_end == weighted_moves )
+    {
+        return INVALID_MOVE;
+    }
+
+    const auto random_weight = random.pick( sum_weights );
+    const WeightMove* iterator = std::upper_bound( weighted_moves, weighted_moves_end,
+                                                   WeightMove{random_weight, INVALID_MOVE} );
+
+    return iterator->second;
 }
 
 bool
@@ -755,6 +1721,8 @@ Board::begin( ) const
 void
 Board::display( ) const
 {
+    //! The walls of the board, whatever the default context
+    const auto& context = *contexts[ m_context ];
     std::cerr << "\n    ";
     for ( int32_t i = 1; i <= N; ++i )
     {
@@ -787,11 +1755,11 @@ Board::display( ) const
                 std::cerr << " . ";
             }
 
-            if ( has_no_vertical_wall( f ) )
+            if ( context.vertical_wall_count[ f ] == 0 )
             {
                 std::cerr << "    ";
             }
-            else if ( has_double_vertical_wall( f ) )
+            else if ( context.vertical_wall_count[ f ] == 2 )
             {
                 std::cerr << " || ";
             }
@@ -817,11 +1785,11 @@ Board::display( ) const
 
                 const int32_t f = N * i + j;
 
-                if ( has_no_horizontal_wall( f ) )
+                if ( context.horizontal_wall_count[ f ] == 0 )
                 {
                     std::cerr << "       ";
                 }
-                else if ( has_double_horizontal_wall( f ) )
+                else if ( context.horizontal_wall_count[ f ] == 2 )
                 {
                     std::cerr << "  ===  ";
                 }
@@ -840,7 +1808,7 @@ Board::display( ) const
     std::cerr << "\nplayer=" << m_player << "\n";
     for ( int32_t i = 0; i < 4; ++i )
     {
-        std::cerr << "moves_" << i << "=" << m_moves[ i ] << "\n";
+        std::cerr << "moves_" << i << "=" << static_cast< int32_t >( m_moves[ i ] ) << "\n";
     }
     std::cerr << "remainig moves=" << m_player_remaining_moves << "\n";
     std::cerr << "turns=" << m_turns << "\n";
@@ -858,31 +1826,30 @@ Board::display( ) const
 void
 Board::next_player( )
 {
-    if ( not is_done( m_player ) or not is_done( m_teammate ) )
+    if ( not is_done( get_player( ) ) or not is_done( get_teammate( ) ) )
     {
         m_moves[ m_player ] += m_player_remaining_moves;
+        update_estimated_moves( get_player( ) );
     }
 
-    switch ( m_player )
+    m_player = ( m_player + 1 ) & 3;
+
+    ++m_turns;
+    m_player_remaining_moves = 3;
+}
+
+template < Board::Player PLAYER >
+void
+Board::next_player( )
+{
+    if ( not is_done( PLAYER ) or not is_done( PlayerTraits< PLAYER >::teammate( ) ) )
     {
-    case YELLOW:
-        m_player = BLACK;
-        m_teammate = RED;
-        break;
-    case BLACK:
-        m_player = WHITE;
-        m_teammate = YELLOW;
-        break;
-    case WHITE:
-        m_player = RED;
-        m_teammate = BLACK;
-        break;
-    case RED:
-        m_player = YELLOW;
-        m_teammate = WHITE;
-        break;
+        m_moves[ PLAYER ] += m_player_remaining_moves;
+        update_estimated_moves< PLAYER >( );
     }
 
+    m_player = PlayerTraits< PLAYER >::next( );
+
     ++m_turns;
     m_player_remaining_moves = 3;
 }
@@ -898,37 +1865,37 @@ Board::get_teammate( const Player player )
 bool
 Board::has_horizontal_wall( const int32_t field )
 {
-    return horizontal_wall_count[ field ] != 0;
+    return contexts[ default_context ]->horizontal_wall_count[ field ] != 0;
 }
 
 bool
 Board::has_vertical_wall( const int32_t field )
 {
-    return vertical_wall_count[ field ] != 0;
+    return contexts[ default_context ]->vertical_wall_count[ field ] != 0;
 }
 
 bool
 Board::has_double_horizontal_wall( const int32_t field )
 {
-    return horizontal_wall_count[ field ] == 2;
+    return contexts[ default_context ]->horizontal_wall_count[ field ] == 2;
 }
 
 bool
 Board::has_double_vertical_wall( const int32_t field )
 {
-    return vertical_wall_count[ field ] == 2;
+    return contexts[ default_context ]->vertical_wall_count[ field ] == 2;
 }
 
 bool
 Board::has_no_horizontal_wall( const int32_t field )
 {
-    return horizontal_wall_count[ field ] == 0;
+    return contexts[ default_context ]->horizontal_wall_count[ field ] == 0;
 }
 
 bool
 Board::has_no_vertical_wall( const int32_t field )
 {
-    return vertical_wall_count[ field ] == 0;
+    return contexts[ default_context ]->vertical_wall_count[ field ] == 0;
 }
 
 bool
@@ -941,69 +1908,117 @@ Board::player_occupies_field( const Board::Player player, const int32_t field )
 bool
 Board::is_done( const Player player ) const
 {
-    return m_bitmasks[ player ] == targets[ player ];
+    return ( m_done >> player ) & 1u;
 }
 
 Move
-Board::get_random_move( ) const
+Board::get_random_move( RandomNumberGenerator& random ) const
 {
-    using WeightMove = std::pair< double, Move >;
+    return begin( ).random_move( random );
+}
 
-    WeightMove weighted_moves[ MAX_MOVES ];
+template < Board::Player PLAYER, bool SOLO >
+Move
+Board::get_random_move( RandomNumberGenerator& random ) const
+{
+    return MoveIterator::create< PLAYER, SOLO >( *this ).random_move( random );
+}
 
-    double sum_weights = 0.0;
-    WeightMove* weighted_moves_end = weighted_moves;
-    for ( auto iterator = begin( ); iterator.valid( ); iterator.next( ) )
+template < Board::Player PLAYER, bool SOLO >
+Move
+Board::do_random_move( RandomNumberGenerator& random )
+{
+    const auto move = get_random_move< PLAYER, SOLO >( random );
+    if ( move != INVALID_MOVE )
     {
-        const auto move = iterator.move( );
-        const int32_t index = iterator.delta_moves( ) + 6;
-        sum_weights += weights[ index ];
-        weighted_moves_end->first = sum_weights;
-        weighted_moves_end->second = move;
-        ++weighted_moves_end;
+        do_move< PLAYER, SOLO >( move );
     }
 
-    if ( weighted_moves_end == weighted_moves )
+    return move;
+}
+
+Move
+Board::do_random_move( RandomNumberGenerator& random )
+{
+    switch ( m_player | m_solo << 2 )
     {
-        return INVALID_MOVE;
+    case YELLOW:
+        return do_random_move< YELLOW, false >( random );
+    case BLACK:
+        return do_random_move< BLACK, false >( random );
+    case WHITE:
+        return do_random_move< WHITE, false >( random );
+    case RED:
+        return do_random_move< RED, false >( random );
+    case YELLOW | 4:
+        return do_random_move< YELLOW, true >( random );
+    case BLACK | 4:
+        return do_random_move< BLACK, true >( random );
+    case WHITE | 4:
+        return do_random_move< WHITE, true >( random );
+    default:
+        return do_random_move< RED, true >( random );
     }
+}
 
-    const auto random_weight = RandomNumberGenerator::pick( sum_weights );
-    const WeightMove* iterator = std::upper_bound( weighted_moves, weighted_moves_end,
-                                                   WeightMove{random_weight, INVALID_MOVE} );
+uint64_t
+Board::get_bitmask( const Player player ) const
+{
+    return m_bitmasks[ player ];
+}
 
-    return iterator->second;
+int32_t
+Board::get_index( const Player player ) const
+{
+    return m_indexes[ player ];
+}
+
+int32_t
+Board::compute_index( const uint64_t bitmask )
+{
+    return CombinationIndex::get( bitmask );
 }
 
 bool
 Board::is_empty( const int32_t field ) const
 {
     const uint64_t flag = 1ull << field;
-    return ( m_filled & flag ) == 0ull;
+    return ( get_filled( ) & flag ) == 0ull;
 }
 
 void
 Board::swap( const int32_t first_field, const int32_t second_field )
 {
-    const auto player = is_done( m_player ) ? m_teammate : m_player;
+    const auto player = is_done( get_player( ) ) ? get_teammate( ) : get_player( );
     const uint64_t first_flag = 1ull << first_field;
     const uint64_t second_flag = 1ull << second_field;
+    m_indexes[ player ] = CombinationIndex::get_moved( m_indexes[ player ], m_bitmasks[ player ],
+                                                       first_field, second_field );
     m_bitmasks[ player ] ^= first_flag | second_flag;
-    m_filled ^= first_flag | second_flag;
+    update_estimated_moves( player );
+}
+
+template < Board::Player PLAYER >
+void
+Board::swap( const int32_t first_field, const int32_t second_field )
+{
+    m_indexes[ PLAYER ] = CombinationIndex::get_moved( m_indexes[ PLAYER ], m_bitmasks[ PLAYER ],
+                                                       first_field, second_field );
+    m_bitmasks[ PLAYER ] ^= ( 1ull << first_field ) | ( 1ull << second_field );
+    update_estimated_moves< PLAYER >( );
 }
 
 bool
 Board::can_do_nil_move( ) const
 {
     return ( m_player_remaining_moves < 3 )
-           or ( m_bitmasks[ m_player ] == targets[ m_player ]
-                and m_bitmasks[ m_teammate ] == targets[ m_teammate ] );
+           or ( is_done( get_player( ) ) and is_done( get_teammate( ) ) );
 }
 
 uint32_t
 Board::get_hash( ) const
 {
-    ZobristData* zobrist = &hash_data;
+    const ZobristData* zobrist = &contexts[ m_context ]->hash_data;
 
     uint32_t h = zobrist->init;
 
@@ -1034,7 +2049,7 @@ Board::get_hash( ) const
 uint32_t
 Board::get_lock( ) const
 {
-    ZobristData* zobrist = &lock_data;
+    const ZobristData* zobrist = &contexts[ m_context ]->lock_data;
 
     uint32_t l = zobrist->init;
 
@@ -1062,6 +2077,35 @@ Board::get_lock( ) const
     return l;
 }
 
+uint64_t
+Board::get_key( ) const
+{
+    const auto& hash_data = contexts[ m_context ]->hash_data;
+    const auto& lock_data = contexts[ m_context ]->lock_data;
+
+    //! The moves of the current player are xored twice, as in get_hash and get_lock
+    uint32_t h = hash_data.init ^ hash_data.player[ m_player ]
+                 ^ hash_data.remaining_moves[ m_player_remaining_moves ];
+    uint32_t l = lock_data.init ^ lock_data.player[ m_player ]
+                 ^ lock_data.remaining_moves[ m_player_remaining_moves ];
+    h ^= hash_data.moves[ m_player ][ m_moves[ m_player ] ];
+    l ^= lock_data.moves[ m_player ][ m_moves[ m_player ] ];
+
+    for ( Player p : players )
+    {
+        h ^= hash_data.moves[ p ][ m_moves[ p ] ];
+        l ^= lock_data.moves[ p ][ m_moves[ p ] ];
+        for ( uint64_t stones = m_bitmasks[ p ]; stones != 0; stones &= stones - 1 )
+        {
+            const int32_t field = __builtin_ctzll( stones );
+            h ^= hash_data.fields[ p ][ field ];
+            l ^= lock_data.fields[ p ][ field ];
+        }
+    }
+
+    return h | static_cast< uint64_t >( l ) << 32;
+}
+
 int32_t
 Board::get_turns( ) const
 {
@@ -1069,40 +2113,13 @@ Board::get_turns( ) const
 }
 
 void
-Board::compute_estimated_moves( const Player player )
+Board::compute_estimated_moves( const Player player, const ContextId context_id )
 {
-    std::queue< uint64_t > q;
-    const uint64_t target = targets[ player ];
-
-    stored[ target ].moves[ player ] = 0;
-    q.push( target );
-
-    while ( not q.empty( ) )
+    auto& context = *contexts[ context_id ];
+    auto& frontier = context.frontiers[ player ];
+    frontier.seed( context, player );
+    while ( frontier.expand( context ) )
     {
-        auto top = q.front( );
-        q.pop( );
-
-        auto& node = stored[ top ];
-
-        int8_t& d_top = node.moves[ player ];
-
-        for ( auto neighbor = node.neighbor; neighbor->valid( ); ++neighbor )
-        {
-            if ( neighbor->check_middle )
-            {
-                continue;
-            }
-
-            const int32_t proposed_count = d_top + neighbor->count;
-            const uint64_t neighbor_bitmask = get_neighbor_bitmask( top, neighbor );
-            int8_t& d_neighbor_bitmask = stored[ neighbor_bitmask ].moves[ player ];
-
-            if ( d_neighbor_bitmask == -1 or d_neighbor_bitmask > proposed_count )
-            {
-                d_neighbor_bitmask = proposed_count;
-                q.push( neighbor_bitmask );
-            }
-        }
     }
 }
 
@@ -1114,66 +2131,33 @@ Board::is_running( const Player p ) const
         return false;
     }
 
-    auto player = is_done( p ) ? get_teammate( p ) : p;
-
-    int32_t corner = 0;
-    switch ( player )
-    {
-    case YELLOW:
-        corner = 7;
-        break;
-    case BLACK:
-        corner = 63;
-        break;
-    case WHITE:
-        corner = 0;
-        break;
-    case RED:
-        corner = 56;
-        break;
-    }
-
-    int32_t min_x = corner / N;
-    int32_t max_x = corner / N;
-    int32_t min_y = corner % N;
-    int32_t max_y = corner % N;
-
-    for ( int32_t f : all_fields )
-    {
-        if ( not player_occupies_field( player, f ) )
-        {
-            continue;
-        }
-
-        int32_t x = f / N;
-        int32_t y = f % N;
-
-        min_x = std::min( min_x, x );
-        max_x = std::max( max_x, x );
-        min_y = std::min( min_y, y );
-        max_y = std::max( max_y, y );
-    }
+    const auto player = is_done( p ) ? get_teammate( p ) : p;
+    return is_running_box( m_bitmasks[ player ], corners[ player ], get_filled( ) );
+}
 
-    for ( int32_t x = min_x; x <= max_x; ++x )
-    {
-        for ( int32_t y = min_y; y <= max_y; ++y )
-        {
-            int32_t f = N * x + y;
-            if ( not is_empty( f ) and not player_occupies_field( player, f ) )
-            {
-                return false;
-            }
-        }
-    }
+template < Board::Player PLAYER >
+bool
+Board::is_running( ) const
+{
+    using Traits = PlayerTraits< PLAYER >;
 
-    return true;
+    const bool done = is_done( PLAYER );
+    const uint64_t bitmask = m_bitmasks[ done ? Traits::teammate( ) : PLAYER ];
+    const int32_t corner
+        = done ? PlayerTraits< Traits::teammate( ) >::corner( ) : Traits::corner( );
+    return is_running_box( bitmask, corner, get_filled( ) );
 }
 
 bool
 Board::is_running( ) const
 {
-    return is_running( YELLOW ) and is_running( BLACK ) and is_running( WHITE )
-           and is_running( RED );
+    if ( m_turns < 24 )
+    {
+        return false;
+    }
+
+    return is_running< YELLOW >( ) and is_running< BLACK >( ) and is_running< WHITE >( )
+           and is_running< RED >( );
 }
 
 Move
@@ -1228,28 +2212,34 @@ Board::evaluate_player( const Player player ) const
 
     const double estimated_moves = get_estimated_moves( player );
     const uint64_t bitmask = m_bitmasks[ player ];
-    const auto& data = stored[ bitmask ];
-    const int8_t moves = data.moves[ player ];
+    const auto& context = *contexts[ m_context ];
+    const int8_t moves = get_stored_moves( context, m_indexes[ player ], player );
 
     double mobility = 0.0;
-    for ( Neighbor* neighbor = data.neighbor; neighbor->valid( ); ++neighbor )
+    for ( uint64_t stones = bitmask; stones != 0ull; stones &= stones - 1 )
     {
-        if ( not is_empty( neighbor->to ) )
+        const int32_t field = __builtin_ctzll( stones );
+        for ( const Neighbor* neighbor = context.field_neighbors[ field ]; neighbor->valid( );
+              ++neighbor )
         {
-            continue;
-        }
+            if ( not is_empty( neighbor->to ) )
+            {
+                continue;
+            }
 
-        if ( neighbor->check_middle and is_empty( neighbor->middle( ) ) )
-        {
-            continue;
-        }
+            if ( neighbor->check_middle and is_empty( neighbor->middle( ) ) )
+            {
+                continue;
+            }
 
-        const uint64_t neighbor_bitmask = get_neighbor_bitmask( bitmask, neighbor );
-        const int64_t neighbor_moves = stored[ neighbor_bitmask ].moves[ player ];
+            const uint64_t neighbor_bitmask = get_neighbor_bitmask( bitmask, neighbor );
+            const int64_t neighbor_moves
+                = get_stored_moves( context, CombinationIndex::get( neighbor_bitmask ), player );
 
-        if ( neighbor_moves < moves )
-        {
-            mobility += moves - neighbor_moves;
+            if ( neighbor_moves < moves )
+            {
+                mobility += moves - neighbor_moves;
+            }
         }
     }
 
@@ -1,5 +1,8 @@
 #pragma once
 
+struct GameContext;
+class RandomNumberGenerator;
+
 class Board
 {
 public:
@@ -23,14 +26,74 @@ public:
         DOWN_2 = 7
     };
 
-    Board( );
-    Board( const Player player, const uint64_t bitmask );
-    Board( const Player player, const uint64_t bitmasks[ 4 ] );
+    //! Index of the GameContext of a walls layout
+    using ContextId = uint8_t;
+    //! Returned by init_context when every index is in use
+    static const ContextId NO_CONTEXT = 0xff;
+
+    explicit Board( const ContextId context = get_default_context( ) );
+    Board( const Player player,
+           const uint64_t bitmask,
+           const ContextId context = get_default_context( ) );
+    Board( const Player player,
+           const uint64_t bitmasks[ 4 ],
+           const ContextId context = get_default_context( ) );
 
     ~Board( );
 
-    static void init_data( const std::string& walls );
-    static void pre_compute( );
+    //! Builds the context of the walls, or finds the one already built, and makes it the
+    //! default context of the new boards and of the walls queries. Only meant for start-up,
+    //! before the games run; the context is kept until the process ends
+    static ContextId init_data( const std::string& walls );
+    //! Same as init_data but leaves the default context alone, so that the concurrent games
+    //! of a server each keep their own. Takes a reference on the context, NO_CONTEXT when the
+    //! walls would need one more context than a process keeps
+    static ContextId init_context( const std::string& walls );
+    //! True for walls of the expected length made of wall counts from 0 to 2, the only ones
+    //! init_context takes from a client
+    static bool are_valid_walls( const std::string& walls );
+    //! Drops a reference taken by init_context, the last one frees the context and its index;
+    //! no board of the context may be used afterwards
+    static void release_context( const ContextId context );
+    static ContextId get_default_context( );
+
+    //! The tables of a context are computed once, later calls return at once
+    static void pre_compute( const ContextId context = get_default_context( ) );
+    //! Only seeds the estimated moves searches, the entries are settled on first read. The
+    //! reads then write the context itself, its store, frontiers and settled distances, so a
+    //! single thread may use the boards of a lazy context
+    static void init_lazy_tables( const ContextId context = get_default_context( ) );
+    //! Builds the estimated moves tables into a POSIX shared memory segment named after the
+    //! walls, or attaches read-only to the one already built by another process. Returns false
+    //! when no segment could be used or the tables are already computed, the tables are then
+    //! left to pre_compute
+    static bool share_tables( const ContextId context = get_default_context( ) );
+    //! Removes the segment of the walls, the processes already attached keep their tables
+    static void unshare_tables( const ContextId context = get_default_context( ) );
+    //! True once the tables are computed or being computed in full, not lazily
+    static bool has_complete_tables( const ContextId context = get_default_context( ) );
+    //! True when every entry of the table of the player is final and no read writes it. Only
+    //! valid once the table is waited for
+    static bool is_table_settled( const Player player,
+                                  const ContextId context = get_default_context( ) );
+    //! Keep mask of the candidate moves of a field, bit k set when the k-th one can be played,
+    //! computed by the AVX2 filter or by the scalar one. The AVX2 filter needs CPU support
+    static uint32_t filter_field_candidates( const int32_t field,
+                                             const uint64_t filled,
+                                             const int32_t remaining_moves,
+                                             const bool avx2,
+                                             const ContextId context = get_default_context( ) );
+    static bool has_avx2_filter( );
+
+    //! Computes the estimated moves tables on the thread pool, one task per player; the players
+    //! of the priority mask are served first
+    static void start_pre_compute( const ContextId context = get_default_context( ) );
+    static void prioritize_tables( const uint32_t players_mask,
+                                   const ContextId context = get_default_context( ) );
+    static void wait_for_tables( const uint32_t players_mask,
+                                 const ContextId context = get_default_context( ) );
+
+    static uint64_t get_start( const Player player );
 
     Player get_player( ) const;
     int32_t do_move( const Move move );
@@ -41,10 +104,15 @@ public:
     double get_score( const Player player ) const;
     double evaluate( const Player player ) const;
     bool is_done( const Player player ) const;
-    Move get_random_move( ) const;
+    Move get_random_move( RandomNumberGenerator& random ) const;
     Move get_best_running_move( ) const;
+    //! Plays a random move with the code specialized for the current player and mode, returns
+    //! the played move or INVALID_MOVE when there is none
+    Move do_random_move( RandomNumberGenerator& random );
     uint32_t get_hash( ) const;
     uint32_t get_lock( ) const;
+    //! The hash in the low half and the lock in the high half, computed in a single pass
+    uint64_t get_key( ) const;
     int32_t get_turns( ) const;
 
     class MoveIterator
@@ -57,23 +125,41 @@ public:
         Move move( ) const;
         int8_t delta_moves( ) const;
 
+        //! Issues prefetches for the Store entries of all the generated moves
+        void prefetch( ) const;
+        //! Picks one of the remaining moves weighted by its delta moves, consumes the iterator
+        Move random_move( RandomNumberGenerator& random );
+
     private:
+        friend class Board;
+
         struct Data
         {
+            //! Store index of the moved stones
+            int32_t index;
             Move move;
-            uint64_t bitmask;
             int8_t count;
         };
 
+        MoveIterator( ) = default;
+
+        //! PLAYER and SOLO must match the board's current player and mode
+        template < Player PLAYER, bool SOLO >
+        static MoveIterator create( const Board& board );
+
+        void set_player( const Board& board, const Player player );
         void try_nil_move( const Board& board );
         void push_moves( const Board& board );
 
+        const GameContext* m_context;
         Player m_player;
         uint64_t m_bitmask;
+        int32_t m_store_index;
         int32_t m_index;
         int32_t m_count;
         int8_t m_actual_moves;
-        Data m_data[ MAX_MOVES ];
+        //! Room for the unconditional writes of the move filtering
+        Data m_data[ MAX_MOVES + 8 ];
     };
 
     MoveIterator begin( ) const;
@@ -108,11 +194,13 @@ public:
         uint8_t count : 2;
         uint8_t from : 6;
         uint8_t to : 6;
+        //! Set for jumps, the middle field must be occupied
         uint8_t check_middle : 2;
     };
 
     void next_player( );
 
+    //! Walls of the default context
     static bool has_horizontal_wall( const int32_t field );
     static bool has_vertical_wall( const int32_t field );
     static bool has_double_horizontal_wall( const int32_t field );
@@ -120,12 +208,22 @@ public:
     static bool has_no_horizontal_wall( const int32_t field );
     static bool has_no_vertical_wall( const int32_t field );
 
-    static Neighbor* compute_neighbors_for( uint64_t bitmask );
+    static void compute_neighbors_for( GameContext& context, const int32_t field );
 
-    static void compute_estimated_moves( const Player player );
+    static void compute_estimated_moves( const Player player, const ContextId context );
 
     double get_estimated_moves( const Player player ) const;
 
+    void update_estimated_moves( const Player player );
+
+    void update_estimated_moves( );
+
+    uint64_t get_bitmask( const Player player ) const;
+
+    int32_t get_index( const Player player ) const;
+
+    static int32_t compute_index( const uint64_t bitmask );
+
     bool player_occupies_field( const Player player, const int32_t field ) const;
 
     bool is_empty( const int32_t field ) const;
@@ -139,12 +237,38 @@ public:
     double evaluate_player( const Player player ) const;
 
 private:
-    Player m_player;
-    Player m_teammate;
-    int32_t m_player_remaining_moves;
+    uint64_t get_filled( ) const;
+    Player get_teammate( ) const;
+
+    //! Variants of the hot paths specialized on the current player and mode: the teammate,
+    //! targets and corners become constants and the remaining moves checks disappear in solo
+    template < Player PLAYER, bool SOLO >
+    int32_t do_move( const Move move );
+    template < Player PLAYER, bool SOLO >
+    Move get_random_move( RandomNumberGenerator& random ) const;
+    template < Player PLAYER, bool SOLO >
+    Move do_random_move( RandomNumberGenerator& random );
+    template < Player PLAYER >
+    void swap( const int32_t first_field, const int32_t second_field );
+    template < Player PLAYER >
+    void update_estimated_moves( );
+    template < Player PLAYER >
+    void next_player( );
+    template < Player PLAYER >
+    bool is_running( ) const;
+
+    //! 64 bytes: the fields occupied by all players are derived from m_bitmasks, the teammate
+    //! from the player and the small counters share a single word; the context id takes the
+    //! former padding
     uint64_t m_bitmasks[ 4 ];
-    uint64_t m_filled;
-    int32_t m_moves[ 4 ];
-    int32_t m_turns;
-    bool m_solo;
+    int32_t m_indexes[ 4 ];
+    uint8_t m_moves[ 4 ];
+    uint8_t m_estimated_moves[ 4 ];
+    int16_t m_score;
+    uint16_t m_player : 2;
+    uint16_t m_player_remaining_moves : 2;
+    uint16_t m_turns : 7;
+    uint16_t m_solo : 1;
+    uint16_t m_done : 4;
+    ContextId m_context;
 };
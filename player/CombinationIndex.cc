@@ -0,0 +1,321 @@
+#include "Common.h"
+
+#include "CombinationIndex.h"
+#include "Timer.h"
+
+#if defined( __x86_64__ )
+#include <immintrin.h>
+#endif
+
+namespace
+{
+//! The last row stands for the missing stones: get_with_bmi2 reads it for a bitmask of less than
+//! four stones, where _tzcnt_u64( 0 ) is 64
+const int32_t c[ 66 ][ 5 ] = {{0, 0, 0, 0, 0},
+                              {1, 0, 0, 0, 0},
+                              {1, 1, 0, 0, 0},
+                              {1, 2, 1, 0, 0},
+                              {1, 3, 3, 1, 0},
+                              {1, 4, 6, 4, 1},
+                              {1, 5, 10, 10, 5},
+                              {1, 6, 15, 20, 15},
+                              {1, 7, 21, 35, 35},
+                              {1, 8, 28, 56, 70},
+                              {1, 9, 36, 84, 126},
+                              {1, 10, 45, 120, 210},
+                              {1, 11, 55, 165, 330},
+                              {1, 12, 66, 220, 495},
+                              {1, 13, 78, 286, 715},
+                              {1, 14, 91, 364, 1001},
+                              {1, 15, 105, 455, 1365},
+                              {1, 16, 120, 560, 1820},
+                              {1, 17, 136, 680, 2380},
+                              {1, 18, 153, 816, 3060},
+                              {1, 19, 171, 969, 3876},
+                              {1, 20, 190, 1140, 4845},
+                              {1, 21, 210, 1330, 5985},
+                              {1, 22, 231, 1540, 7315},
+                              {1, 23, 253, 1771, 8855},
+                              {1, 24, 276, 2024, 10626},
+                              {1, 25, 300, 2300, 12650},
+                              {1, 26, 325, 2600, 14950},
+                              {1, 27, 351, 2925, 17550},
+                              {1, 28, 378, 3276, 20475},
+                              {1, 29, 406, 3654, 23751},
+                              {1, 30, 435, 4060, 27405},
+                              {1, 31, 465, 4495, 31465},
+                              {1, 32, 496, 4960, 35960},
+                              {1, 33, 528, 5456, 40920},
+                              {1, 34, 561, 5984, 46376},
+                              {1, 35, 595, 6545, 52360},
+                              {1, 36, 630, 7140, 58905},
+                              {1, 37, 666, 7770, 66045},
+                              {1, 38, 703, 8436, 73815},
+                              {1, 39, 741, 9139, 82251},
+                              {1, 40, 780, 9880, 91390},
+                              {1, 41, 820, 10660, 101270},
+                              {1, 42, 861, 11480, 111930},
+                              {1, 43, 903, 12341, 123410},
+                              {1, 44, 946, 13244, 135751},
+                              {1, 45, 990, 14190, 148995},
+                              {1, 46, 1035, 15180, 163185},
+                              {1, 47, 1081, 16215, 178365},
+                              {1, 48, 1128, 17296, 194580},
+                              {1, 49, 1176, 18424, 211876},
+                              {1, 50, 1225, 19600, 230300},
+                              {1, 51, 1275, 20825, 249900},
+                              {1, 52, 1326, 22100, 270725},
+                              {1, 53, 1378, 23426, 292825},
+                              {1, 54, 1431, 24804, 316251},
+                              {1, 55, 1485, 26235, 341055},
+                              {1, 56, 1540, 27720, 367290},
+                              {1, 57, 1596, 29260, 395010},
+                              {1, 58, 1653, 30856, 424270},
+                              {1, 59, 1711, 32509, 455126},
+                              {1, 60, 1770, 34220, 487635},
+                              {1, 61, 1830, 35990, 521855},
+                              {1, 62, 1891, 37820, 557845},
+                              {1, 63, 1953, 39711, 595665},
+                              {0, 0, 0, 0, 0}};
+
+//! partial_ranks[ byte ][ stones ][ value ]: contribution of the byte at position byte having
+//! the given value when stones stones are already found in the lower bytes.
+int32_t partial_ranks[ 8 ][ 5 ][ 256 ];
+uint8_t bits_count[ 256 ];
+
+constexpr int32_t MAX_INDEX = 635376;
+
+//! Fields of the stones of each index packed on 6 bits each, the inverse of the rank
+uint32_t index_fields[ MAX_INDEX ];
+}
+
+CombinationIndex::Function CombinationIndex::s_function = CombinationIndex::get_with_ffs;
+
+void
+CombinationIndex::init_data( )
+{
+    static bool initialized = false;
+    if ( initialized )
+    {
+        return;
+    }
+
+    initialized = true;
+
+    for ( int32_t value = 0; value < 256; ++value )
+    {
+        bits_count[ value ] = 0;
+        for ( int32_t bit = 0; bit < 8; ++bit )
+        {
+            bits_count[ value ] += ( value >> bit ) & 1;
+        }
+    }
+
+    for ( int32_t byte = 0; byte < 8; ++byte )
+    {
+        for ( int32_t stones = 0; stones <= 4; ++stones )
+        {
+            for ( int32_t value = 0; value < 256; ++value )
+            {
+                int32_t rank = stones;
+                int32_t partial_rank = 0;
+                for ( int32_t bit = 0; bit < 8 and rank < 4; ++bit )
+                {
+                    if ( ( value >> bit ) & 1 )
+                    {
+                        partial_rank += c[ 8 * byte + bit + 1 ][ ++rank ];
+                    }
+                }
+
+                partial_ranks[ byte ][ stones ][ value ] = partial_rank;
+            }
+        }
+    }
+
+    //! Enumerating with the highest stone varying slowest visits the ranks in order
+    int32_t index = 0;
+    for ( uint32_t fourth = 3; fourth < NXN; ++fourth )
+    {
+        for ( uint32_t third = 2; third < fourth; ++third )
+        {
+            for ( uint32_t second = 1; second < third; ++second )
+            {
+                for ( uint32_t first = 0; first < second; ++first )
+                {
+                    index_fields[ index++ ] = first | second << 6 | third << 12 | fourth << 18;
+                }
+            }
+        }
+    }
+
+    select( );
+}
+
+void
+CombinationIndex::select( )
+{
+    struct Candidate
+    {
+        const char* name;
+        Function function;
+    };
+
+    std::vector< Candidate > candidates{{"ffs", get_with_ffs}, {"bytes", get_with_bytes}};
+    if ( has_bmi2( ) )
+    {
+        candidates.push_back( {"bmi2", get_with_bmi2} );
+    }
+
+    std::vector< uint64_t > bitmasks;
+    std::mt19937_64 engine{};
+    while ( bitmasks.size( ) < 4096 )
+    {
+        uint64_t bitmask = 0ull;
+        while ( __builtin_popcountll( bitmask ) < 4 )
+        {
+            bitmask |= 1ull << ( engine( ) & 0x3f );
+        }
+
+        bitmasks.push_back( bitmask );
+    }
+
+    double best_time = OO;
+    const char* best_name = nullptr;
+    for ( const auto& candidate : candidates )
+    {
+        Timer timer;
+        volatile int32_t checksum = 0;
+        for ( int32_t round = 0; round < 16; ++round )
+        {
+            for ( const auto bitmask : bitmasks )
+            {
+                checksum += candidate.function( bitmask );
+            }
+        }
+
+        timer.stop( );
+
+        if ( best_time > timer.get_delta_time( ) )
+        {
+            best_time = timer.get_delta_time( );
+            best_name = candidate.name;
+            s_function = candidate.function;
+        }
+    }
+
+    std::cerr << "Combination index = " << best_name << "\n";
+}
+
+int32_t
+CombinationIndex::get_with_ffs( const uint64_t bitmask )
+{
+    uint64_t b = bitmask;
+    int32_t index = 0;
+    int32_t d = 1;
+    int32_t last = 0;
+    for ( int32_t l = 0; l < 4; ++l )
+    {
+        int32_t a = __builtin_ffsll( b );
+        index += c[ last + a ][ d++ ];
+        b >>= a;
+        last += a;
+    }
+
+    return index;
+}
+
+int32_t
+CombinationIndex::get_with_bytes( const uint64_t bitmask )
+{
+    int32_t index = 0;
+    int32_t stones = 0;
+    for ( uint64_t b = bitmask; b != 0ull; )
+    {
+        const int32_t byte = __builtin_ctzll( b ) >> 3;
+        const uint8_t value = b >> ( byte << 3 );
+        index += partial_ranks[ byte ][ stones ][ value ];
+        stones += bits_count[ value ];
+        b &= ~( 0xffull << ( byte << 3 ) );
+    }
+
+    return index;
+}
+
+#if defined( __x86_64__ )
+__attribute__( ( target( "bmi,bmi2" ) ) ) int32_t
+CombinationIndex::get_with_bmi2( const uint64_t bitmask )
+{
+    //! pdep of the k-th lowest bit selects the k-th stone of the bitmask, so the four
+    //! positions are found without the dependency chain of the ffs loop
+    return c[ _tzcnt_u64( _pdep_u64( 1ull, bitmask ) ) + 1 ][ 1 ]
+           + c[ _tzcnt_u64( _pdep_u64( 2ull, bitmask ) ) + 1 ][ 2 ]
+           + c[ _tzcnt_u64( _pdep_u64( 4ull, bitmask ) ) + 1 ][ 3 ]
+           + c[ _tzcnt_u64( _pdep_u64( 8ull, bitmask ) ) + 1 ][ 4 ];
+}
+
+bool
+CombinationIndex::has_bmi2( )
+{
+    return __builtin_cpu_supports( "bmi2" );
+}
+#else
+int32_t
+CombinationIndex::get_with_bmi2( const uint64_t bitmask )
+{
+    return get_with_bytes( bitmask );
+}
+
+bool
+CombinationIndex::has_bmi2( )
+{
+    return false;
+}
+#endif
+
+int32_t
+CombinationIndex::get_moved( int32_t index,
+                             const uint64_t bitmask,
+                             const int32_t from,
+                             const int32_t to )
+{
+    //! Only the moved stone and the stones lying between from and to change their rank
+    int32_t rank = __builtin_popcountll( bitmask & ( ( 1ull << from ) - 1 ) ) + 1;
+    index -= c[ from + 1 ][ rank ];
+
+    if ( from < to )
+    {
+        uint64_t between = bitmask & ( ( 1ull << to ) - 1 ) & ~( ( 2ull << from ) - 1 );
+        for ( ; between != 0ull; between &= between - 1 )
+        {
+            const int32_t field = __builtin_ctzll( between );
+            index += c[ field + 1 ][ rank ] - c[ field + 1 ][ rank + 1 ];
+            ++rank;
+        }
+    }
+    else
+    {
+        uint64_t between = bitmask & ( ( 1ull << from ) - 1 ) & ~( ( 2ull << to ) - 1 );
+        for ( ; between != 0ull; between ^= 1ull << ( 63 - __builtin_clzll( between ) ) )
+        {
+            const int32_t field = 63 - __builtin_clzll( between );
+            index += c[ field + 1 ][ rank ] - c[ field + 1 ][ rank - 1 ];
+            --rank;
+        }
+    }
+
+    return index + c[ to + 1 ][ rank ];
+}
+
+uint64_t
+CombinationIndex::get_bitmask( const int32_t index )
+{
+    const uint32_t fields = index_fields[ index ];
+    return 1ull << ( fields & 0x3f ) | 1ull << ( ( fields >> 6 ) & 0x3f )
+           | 1ull << ( ( fields >> 12 ) & 0x3f ) | 1ull << ( fields >> 18 );
+}
+
+void
+CombinationIndex::prefetch( const int32_t index )
+{
+    __builtin_prefetch( &index_fields[ index ] );
+}
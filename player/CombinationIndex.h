@@ -0,0 +1,35 @@
+#pragma once
+
+//! Rank of a 4-stones bitmask in the combinatorial number system, used as index in the
+//! precomputed tables. Several implementations are available, the fastest one on the
+//! running CPU is picked by select( ).
+class CombinationIndex
+{
+public:
+    using Function = int32_t ( * )( const uint64_t bitmask );
+
+    static void init_data( );
+    static void select( );
+    static int32_t get( const uint64_t bitmask );
+    static int32_t get_moved( int32_t index,
+                              const uint64_t bitmask,
+                              const int32_t from,
+                              const int32_t to );
+    //! Inverse of get( )
+    static uint64_t get_bitmask( const int32_t index );
+    static void prefetch( const int32_t index );
+
+    static int32_t get_with_ffs( const uint64_t bitmask );
+    static int32_t get_with_bytes( const uint64_t bitmask );
+    static int32_t get_with_bmi2( const uint64_t bitmask );
+    static bool has_bmi2( );
+
+private:
+    static Function s_function;
+};
+
+inline int32_t
+CombinationIndex::get( const uint64_t bitmask )
+{
+    return s_function( bitmask );
+}
@@ -7,14 +7,17 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -22,11 +25,82 @@
 #define N 8
 #define NXN 64
 #define NXNX8 512
-#define NIL_MOVE ( (int32_t)-1 )
-#define INVALID_MOVE ( (int32_t)-2 )
+#define NIL_MOVE ( (int16_t)-1 )
+#define INVALID_MOVE ( (int16_t)-2 )
 #define CREATE_MOVE( from, to ) ( ( from ) | ( ( to ) << 6 ) )
 #define OO 1000000000
 #define MAX_MOVES 17
+#define MAX_ACTION_MOVES 3
+#define MAX_RUN_MOVES 128
 
-using Move = int32_t;
-using Action = std::vector< Move >;
+//! 12 bits: from | to << 6, negative values are the NIL and INVALID sentinels
+using Move = int16_t;
+
+//! Fixed capacity sequence of moves stored inline, copying it never allocates
+template < int32_t CAPACITY >
+class SmallAction
+{
+public:
+    SmallAction( )
+        : m_size( 0 )
+    {
+    }
+
+    void
+    push_back( const Move move )
+    {
+        assert( m_size < CAPACITY );
+        m_moves[ m_size++ ] = move;
+    }
+
+    void
+    clear( )
+    {
+        m_size = 0;
+    }
+
+    bool
+    empty( ) const
+    {
+        return m_size == 0;
+    }
+
+    bool
+    full( ) const
+    {
+        return m_size == CAPACITY;
+    }
+
+    int32_t
+    size( ) const
+    {
+        return m_size;
+    }
+
+    Move
+    operator[]( const int32_t index ) const
+    {
+        return m_moves[ index ];
+    }
+
+    const Move*
+    begin( ) const
+    {
+        return m_moves;
+    }
+
+    const Move*
+    end( ) const
+    {
+        return m_moves + m_size;
+    }
+
+private:
+    Move m_moves[ CAPACITY ];
+    uint8_t m_size;
+};
+
+//! A turn is at most three moves
+using Action = SmallAction< MAX_ACTION_MOVES >;
+//! A whole solo run, from the start fields to the targets
+using RunAction = SmallAction< MAX_RUN_MOVES >;
@@ -2,6 +2,23 @@
 
 #include "Conversion.h"
 
+namespace
+{
+bool
+is_valid_field( const char line, const char column )
+{
+    return line >= 'a' and line <= 'h' and column >= '1' and column <= '8';
+}
+
+bool
+is_valid_move( const std::string& s )
+{
+    return s == "Nil"
+           or ( s.size( ) == 4 and is_valid_field( s[ 0 ], s[ 1 ] )
+                and is_valid_field( s[ 2 ], s[ 3 ] ) );
+}
+}
+
 Move
 Conversion::string_to_move( const std::string& s )
 {
@@ -54,7 +71,7 @@ Conversion::string_to_action( const std::string& s )
     std::istringstream iss( s );
     std::string token;
     Action action;
-    while ( std::getline( iss, token, delimiter ) )
+    while ( not action.full( ) and std::getline( iss, token, delimiter ) )
     {
         action.push_back( string_to_move( token ) );
     }
@@ -62,6 +79,25 @@ Conversion::string_to_action( const std::string& s )
     return action;
 }
 
+bool
+Conversion::is_valid_action( const std::string& s )
+{
+    const char delimiter = ':';
+
+    std::istringstream iss( s );
+    std::string token;
+    int32_t moves = 0;
+    while ( std::getline( iss, token, delimiter ) )
+    {
+        if ( ++moves > MAX_ACTION_MOVES or not is_valid_move( token ) )
+        {
+            return false;
+        }
+    }
+
+    return moves > 0 and s.back( ) != delimiter;
+}
+
 std::string
 Conversion::action_to_string( const Action& action )
 {
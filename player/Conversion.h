@@ -5,6 +5,10 @@ class Conversion
 public:
     static Move string_to_move( const std::string& s );
     static std::string move_to_string( const Move move );
+    //! The moves past the capacity of an action are dropped, the input of the other players is
+    //! checked with is_valid_action first
     static Action string_to_action( const std::string& s );
+    //! At most MAX_ACTION_MOVES moves separated by ':', each one "Nil" or two fields
+    static bool is_valid_action( const std::string& s );
     static std::string action_to_string( const Action& action );
 };
@@ -0,0 +1,298 @@
+#include "Common.h"
+
+#include "Coordinator.h"
+
+#include "Board.h"
+#include "Conversion.h"
+#include "SearchContext.h"
+#include "SocketBuffer.h"
+#include "Timer.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+//! Iterations of a worker between two reports
+const int32_t REPORT_INTERVAL = 2000;
+//! Microseconds between two merges of the reports
+const int32_t MERGE_INTERVAL = 200000;
+
+std::string
+path_to_string( const std::vector< Move >& path )
+{
+    Action action;
+    for ( const auto move : path )
+    {
+        action.push_back( move );
+    }
+
+    return Conversion::action_to_string( action );
+}
+
+std::vector< Move >
+string_to_path( const std::string& s )
+{
+    const auto action = Conversion::string_to_action( s );
+    return std::vector< Move >( action.begin( ), action.end( ) );
+}
+
+void
+add_stats( const MCTSStrategy::PathStats& stats, MCTSStrategy::PathStats& merged )
+{
+    for ( const auto& entry : stats )
+    {
+        auto& merged_stats = merged[ entry.first ];
+        const int32_t visits = merged_stats.visits + entry.second.visits;
+        if ( visits > 0 )
+        {
+            merged_stats.value = ( merged_stats.value * merged_stats.visits
+                                   + entry.second.value * entry.second.visits )
+                                 / visits;
+            merged_stats.visits = visits;
+        }
+    }
+}
+}
+
+Coordinator::Coordinator( const std::string& walls, const int32_t workers_count )
+    : m_walls( walls )
+    , m_workers( std::max( workers_count, 1 ) )
+{
+    for ( auto& worker : m_workers )
+    {
+        worker.pid = -1;
+        worker.fd = -1;
+    }
+}
+
+Coordinator::~Coordinator( )
+{
+    for ( auto& worker : m_workers )
+    {
+        if ( worker.fd >= 0 )
+        {
+            close( worker.fd );
+        }
+
+        if ( worker.pid > 0 )
+        {
+            waitpid( worker.pid, nullptr, 0 );
+        }
+    }
+}
+
+bool
+Coordinator::start_worker( Worker& worker )
+{
+    //! Only the end of the worker survives its exec
+    int fds[ 2 ];
+    if ( socketpair( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds ) != 0 )
+    {
+        return false;
+    }
+
+    const std::string fd_argument = std::to_string( fds[ 1 ] );
+    const pid_t pid = fork( );
+    if ( pid == 0 )
+    {
+        fcntl( fds[ 1 ], F_SETFD, 0 );
+        execl( "/proc/self/exe", "Player", "--analyze-worker", fd_argument.c_str( ), nullptr );
+        _exit( 127 );
+    }
+
+    close( fds[ 1 ] );
+    if ( pid < 0 )
+    {
+        close( fds[ 0 ] );
+        return false;
+    }
+
+    worker.pid = pid;
+    worker.fd = fds[ 0 ];
+    worker.iterations = 0;
+    worker.done = false;
+    worker.stats.clear( );
+
+    return true;
+}
+
+Action
+Coordinator::get_best_action( const std::vector< Action >& actions, RandomNumberGenerator& random )
+{
+    std::cerr << "Using Coordinator with " << m_workers.size( ) << " workers\n";
+
+    std::vector< std::thread > readers;
+    for ( auto& worker : m_workers )
+    {
+        if ( not start_worker( worker ) )
+        {
+            std::cerr << "Cannot start a worker\n";
+            continue;
+        }
+
+        SocketBuffer buffer( worker.fd );
+        std::ostream out( &buffer );
+        out << m_walls << "\n" << random.pick( ) << "\n";
+        for ( const auto& action : actions )
+        {
+            out << Conversion::action_to_string( action ) << "\n";
+        }
+
+        out << "End" << std::endl;
+        if ( not out )
+        {
+            std::cerr << "Worker " << worker.pid << " is gone before its search\n";
+            worker.done = true;
+            continue;
+        }
+
+        readers.emplace_back( &Coordinator::read_reports, this, std::ref( worker ) );
+    }
+
+    Timer timer;
+    MCTSStrategy::PathStats merged;
+    for ( bool done = false; not done; )
+    {
+        usleep( MERGE_INTERVAL );
+
+        int32_t iterations = 0;
+        merged.clear( );
+        done = true;
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            for ( const auto& worker : m_workers )
+            {
+                add_stats( worker.stats, merged );
+                iterations += worker.iterations;
+                done = done and ( worker.done or worker.fd < 0 );
+            }
+        }
+
+        std::cerr << "\tmerged i=" << iterations << " "
+                  << Conversion::action_to_string( MCTSStrategy::select_action( merged ) )
+                  << "\n";
+    }
+
+    for ( auto& reader : readers )
+    {
+        reader.join( );
+    }
+
+    timer.stop( );
+
+    const auto best_action = MCTSStrategy::select_action( merged );
+    std::cerr << "\tdt=" << timer.get_delta_time( ) << "\n\t"
+              << Conversion::action_to_string( best_action ) << std::endl;
+
+    return best_action;
+}
+
+void
+Coordinator::read_reports( Worker& worker )
+{
+    SocketBuffer buffer( worker.fd );
+    std::istream in( &buffer );
+
+    //! A report replaces the previous one of the worker, the trees only grow. A report cut by
+    //! the death of the worker is never merged
+    std::string s;
+    while ( in >> s and s == "report" )
+    {
+        int32_t iterations = 0;
+        MCTSStrategy::PathStats stats;
+        in >> iterations;
+        for ( in >> s; in and s != "end"; in >> s )
+        {
+            Node::Stats path_stats;
+            in >> path_stats.visits >> path_stats.value;
+            stats[ string_to_path( s ) ] = path_stats;
+        }
+
+        if ( not in )
+        {
+            break;
+        }
+
+        std::lock_guard< std::mutex > lock( m_mutex );
+        worker.iterations = iterations;
+        worker.stats.swap( stats );
+    }
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    if ( not in or s != "done" )
+    {
+        //! The search of a dead worker is dropped, the others still decide
+        std::cerr << "Worker " << worker.pid << " stopped without reporting its end\n";
+        worker.iterations = 0;
+        worker.stats.clear( );
+    }
+
+    worker.done = true;
+}
+
+int
+Coordinator::serve_worker( const int fd )
+{
+    SocketBuffer buffer( fd );
+    std::istream in( &buffer );
+    std::ostream out( &buffer );
+
+    std::string walls;
+    uint32_t seed;
+    if ( not( in >> walls >> seed ) )
+    {
+        return 1;
+    }
+
+    //! Mapped from the segment of the coordinator, computed here only when it cannot be shared
+    const auto context = Board::init_context( walls );
+    if ( context == Board::NO_CONTEXT )
+    {
+        return 1;
+    }
+
+    if ( not Board::share_tables( context ) )
+    {
+        Board::pre_compute( context );
+    }
+
+    Board board{context};
+    std::string s;
+    for ( in >> s; in and s != "End"; in >> s )
+    {
+        board.do_action( Conversion::string_to_action( s ) );
+    }
+
+    SearchContext search;
+    search.random.seed( seed );
+
+    MCTSStrategy strategy( search, board.get_player( ) );
+    strategy.set_report( REPORT_INTERVAL, [&out]( const Node* root, const int32_t iteration ) {
+        MCTSStrategy::PathStats stats;
+        MCTSStrategy::add_path_stats( root, stats );
+
+        out << "report " << iteration << "\n";
+        for ( const auto& entry : stats )
+        {
+            out << path_to_string( entry.first ) << " " << entry.second.visits << " "
+                << entry.second.value << "\n";
+        }
+
+        out << "end" << std::endl;
+        if ( not out )
+        {
+            //! The coordinator is gone, nobody reads the search
+            _exit( 1 );
+        }
+    } );
+
+    strategy.get_best_action( board );
+    out << "done" << std::endl;
+    close( fd );
+    Board::release_context( context );
+
+    return 0;
+}
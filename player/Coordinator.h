@@ -0,0 +1,44 @@
+#pragma once
+
+#include "MCTSStrategy.h"
+
+#include <sys/types.h>
+
+//! Searches one position with an independent MCTS in each of several worker processes. The
+//! workers are Player processes started over socket pairs, each one with its own seed; they
+//! report the stats of their root moves at fixed intervals and the coordinator picks the action
+//! from the sum of the last reports.
+class Coordinator
+{
+public:
+    Coordinator( const std::string& walls, const int32_t workers_count );
+    ~Coordinator( );
+
+    Coordinator( const Coordinator& ) = delete;
+    Coordinator& operator=( const Coordinator& ) = delete;
+
+    //! The position is given by the actions played from the start
+    Action get_best_action( const std::vector< Action >& actions, RandomNumberGenerator& random );
+
+    //! Body of a worker process: reads the position from the socket, searches it and writes the
+    //! reports back, returns the exit code
+    static int serve_worker( const int fd );
+
+private:
+    struct Worker
+    {
+        pid_t pid;
+        int fd;
+        int32_t iterations;
+        bool done;
+        MCTSStrategy::PathStats stats;
+    };
+
+    bool start_worker( Worker& worker );
+    void read_reports( Worker& worker );
+
+    std::string m_walls;
+    std::vector< Worker > m_workers;
+    //! Guards the reports of the workers
+    std::mutex m_mutex;
+};
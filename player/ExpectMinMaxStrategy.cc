@@ -4,6 +4,8 @@
 
 #include "Board.h"
 #include "Conversion.h"
+#include "SearchContext.h"
+#include "ThreadPool.h"
 #include "Timer.h"
 
 namespace
@@ -37,20 +39,40 @@ get_next_depth( const Board& board, const Board& next_board, const int32_t depth
 }
 
 const int32_t START_DEPTH = 1;
+//! The iterations up to this depth are never aborted, so there is always a result
 const int32_t MIN_DEPTH = 2;
-const int32_t MAX_DEPTH = 2;
-const int32_t MAX_NODES = 2000000;
-
-const double DEFAULT_BRANCHING_FACTOR = 10.0;
+const int32_t MAX_DEPTH = 32;
+//! A deeper iteration is only started while less than this share of the turn time is used
+const double NEXT_DEPTH_TIME_SHARE = 0.4;
+//! Searched nodes between two checks of the deadline
+const int32_t DEADLINE_CHECK_MASK = 0x3ff;
+//! Plies where the helpers change the order of the moves
+const int32_t VARIED_ORDER_PLIES = 2;
+
+uint64_t
+get_key_salt( const Board::Player player )
+{
+    return 0x9e3779b97f4a7c15ull * ( player + 1 );
+}
 }
 
-ExpectMinMaxStrategy::ExpectMinMaxStrategy( const Board::Player player )
-    : m_player( player )
+ExpectMinMaxStrategy::ExpectMinMaxStrategy( SearchContext& context, const Board::Player player )
+    : m_context( context )
+    , m_player( player )
     , m_teammate( Board::get_teammate( player ) )
+    , m_key_salt( get_key_salt( player ) )
     , m_nodes( 0 )
+    , m_turn_nodes( 0 )
+    , m_completed_depth( 0 )
+    , m_helper( 0 )
+    , m_stop( nullptr )
     , m_cutoff( 0 )
+    , m_checks( 0 )
+    , m_ply( 0 )
+    , m_on_line( false )
     , m_can_abort( false )
     , m_aborted( false )
+    , m_transposition_table( context.get_transposition_table( ) )
 {
 }
 
@@ -58,16 +80,108 @@ ExpectMinMaxStrategy::~ExpectMinMaxStrategy( )
 {
 }
 
+void
+ExpectMinMaxStrategy::search_as_helper( const Board& board,
+                                        const int32_t helper,
+                                        const std::atomic< bool >& stop )
+{
+    m_helper = helper;
+    m_stop = &stop;
+    m_can_abort = true;
+
+    //! Every other helper is one depth ahead of the main search. A helper stopped before it
+    //! starts gives up on its first deadline check
+    for ( int32_t depth = START_DEPTH + helper % 2; depth <= MAX_DEPTH; ++depth )
+    {
+        init_search( );
+        search( board, -OO, +OO, depth );
+        m_turn_nodes += m_nodes;
+        if ( m_aborted )
+        {
+            break;
+        }
+
+        m_completed_depth = depth;
+        m_line.assign( m_pv[ 0 ], m_pv[ 0 ] + m_pv_length[ 0 ] );
+    }
+}
+
 void
 ExpectMinMaxStrategy::init_search( )
 {
     m_nodes = 0;
     m_cutoff = 0;
+    m_checks = 0;
+    m_ply = 0;
+    m_on_line = not m_line.empty( );
     m_aborted = false;
 }
 
 bool
-ExpectMinMaxStrategy::look_in_transposition_table( const Board& board,
+ExpectMinMaxStrategy::is_stopped( ) const
+{
+    return m_stop != nullptr ? m_stop->load( std::memory_order_relaxed )
+                             : m_deadline.is_time_over( );
+}
+
+void
+ExpectMinMaxStrategy::vary_order( Move* sorted_moves, Move* sorted_moves_end ) const
+{
+    const int32_t count = static_cast< int32_t >( sorted_moves_end - sorted_moves );
+    if ( m_helper > 0 and m_ply < VARIED_ORDER_PLIES and count > 1 )
+    {
+        std::rotate( sorted_moves, sorted_moves + m_helper % count, sorted_moves_end );
+    }
+}
+
+double
+ExpectMinMaxStrategy::search_child( const Board& board,
+                                    const Board& next_board,
+                                    const Move move,
+                                    const double alpha,
+                                    const double beta,
+                                    const int32_t depth )
+{
+    const bool on_line = m_on_line;
+    m_on_line = on_line and m_ply < static_cast< int32_t >( m_line.size( ) )
+                and m_line[ m_ply ] == move;
+    ++m_ply;
+
+    const int32_t next_depth = get_next_depth( board, next_board, depth );
+    const double value = search( next_board, alpha, beta, next_depth );
+
+    --m_ply;
+    m_on_line = on_line;
+
+    return value;
+}
+
+void
+ExpectMinMaxStrategy::update_pv( const Move move )
+{
+    const int32_t ply = m_ply;
+    const int32_t child_length = m_pv_length[ ply + 1 ];
+    m_pv[ ply ][ ply ] = move;
+    std::copy( m_pv[ ply + 1 ] + ply + 1, m_pv[ ply + 1 ] + child_length, m_pv[ ply ] + ply + 1 );
+    m_pv_length[ ply ] = std::max( child_length, ply + 1 );
+}
+
+void
+ExpectMinMaxStrategy::store( const uint64_t key,
+                             const int32_t depth,
+                             const Entry::Type type,
+                             const double value,
+                             const Move move )
+{
+    //! The value of an aborted node is meaningless and the table outlives the turn
+    if ( not m_aborted )
+    {
+        m_transposition_table.store( key, depth, type, value, move );
+    }
+}
+
+bool
+ExpectMinMaxStrategy::look_in_transposition_table( const uint64_t key,
                                                    const int32_t depth,
                                                    double& alpha,
                                                    double& beta,
@@ -75,53 +189,60 @@ ExpectMinMaxStrategy::look_in_transposition_table( const Board& board,
                                                    Move* best_move_ptr,
                                                    Move& PV )
 {
-    const auto entry = m_transposition_table.find( board );
-    if ( entry != nullptr and entry->depth == depth )
+    Entry entry;
+    const bool found = m_transposition_table.find( key, entry );
+    if ( found and entry.depth == depth )
     {
-        switch ( entry->type )
+        switch ( entry.type )
         {
         case Entry::EXACT:
             ++m_nodes;
             if ( best_move_ptr != nullptr )
             {
-                *best_move_ptr = entry->move;
+                *best_move_ptr = entry.move;
             }
-            value = entry->value;
+            if ( entry.move != INVALID_MOVE )
+            {
+                m_pv[ m_ply ][ m_ply ] = entry.move;
+                m_pv_length[ m_ply ] = m_ply + 1;
+            }
+            value = entry.value;
             return true;
         case Entry::LOWER:
-            if ( entry->value >= beta )
+            if ( entry.value >= beta )
             {
                 ++m_nodes;
-                value = entry->value;
+                value = entry.value;
                 return true;
             }
             else
             {
-                alpha = std::max( alpha, entry->value );
+                alpha = std::max< double >( alpha, entry.value );
             }
             break;
         case Entry::UPPER:
-            if ( entry->value <= alpha )
+            if ( entry.value <= alpha )
             {
                 ++m_nodes;
-                value = entry->value;
+                value = entry.value;
                 return true;
             }
             else
             {
-                beta = std::min( beta, entry->value );
+                beta = std::min< double >( beta, entry.value );
             }
             break;
         }
     }
 
-    PV = entry != nullptr ? entry->move : INVALID_MOVE;
+    PV = found ? entry.move : INVALID_MOVE;
 
     return false;
 }
 
 double
 ExpectMinMaxStrategy::get_best_value( const Board& board,
+                                      const uint64_t key,
                                       const double alpha,
                                       const double beta,
                                       const int32_t depth,
@@ -136,12 +257,12 @@ ExpectMinMaxStrategy::get_best_value( const Board& board,
         zero_move = false;
         Board next_board = board;
         next_board.do_move( move );
-        const int32_t next_depth = get_next_depth( board, next_board, depth );
-        double value = search( next_board, local_alpha, beta, next_depth );
+        double value = search_child( board, next_board, move, local_alpha, beta, depth );
         if ( best_value < value )
         {
             best_value = value;
             best_move = move;
+            update_pv( move );
         }
 
         local_alpha = std::max( local_alpha, value );
@@ -150,10 +271,15 @@ ExpectMinMaxStrategy::get_best_value( const Board& board,
     if ( is_valid( board, PV ) )
     {
         process_move( PV );
+        if ( m_aborted )
+        {
+            return 0.0;
+        }
     }
 
     Move sorted_moves[ MAX_MOVES ];
     auto sorted_moves_end = board.get_sorted_moves( sorted_moves );
+    vary_order( sorted_moves, sorted_moves_end );
     for ( auto move_ptr = sorted_moves; move_ptr != sorted_moves_end; ++move_ptr )
     {
         if ( best_value >= beta )
@@ -183,13 +309,14 @@ ExpectMinMaxStrategy::get_best_value( const Board& board,
     }
 
     auto entry_type = get_entry_type( best_value, alpha, beta );
-    m_transposition_table.store( board, depth, entry_type, best_value, best_move );
+    store( key, depth, entry_type, best_value, best_move );
 
     return best_value;
 }
 
 double
 ExpectMinMaxStrategy::get_average_value( const Board& board,
+                                         const uint64_t key,
                                          const double alpha,
                                          const double beta,
                                          const int32_t depth )
@@ -203,8 +330,8 @@ ExpectMinMaxStrategy::get_average_value( const Board& board,
         Board next_board = board;
         next_board.do_move( iterator.move( ) );
         const double weight = std::pow( 10.0, iterator.delta_moves( ) );
-        const int32_t next_depth = get_next_depth( board, next_board, depth );
-        const double value = search( next_board, alpha, beta, next_depth );
+        const double value
+            = search_child( board, next_board, iterator.move( ), alpha, beta, depth );
         sum_values += weight * value;
         sum_weights += weight;
 
@@ -221,13 +348,14 @@ ExpectMinMaxStrategy::get_average_value( const Board& board,
 
     const double average_value = sum_values / sum_weights;
     auto entry_type = get_entry_type( average_value, alpha, beta );
-    m_transposition_table.store( board, depth, entry_type, average_value, INVALID_MOVE );
+    store( key, depth, entry_type, average_value, INVALID_MOVE );
 
     return average_value;
 }
 
 double
 ExpectMinMaxStrategy::get_worst_value( const Board& board,
+                                       const uint64_t key,
                                        const double alpha,
                                        const double beta,
                                        const int32_t depth,
@@ -241,12 +369,12 @@ ExpectMinMaxStrategy::get_worst_value( const Board& board,
         zero_move = false;
         Board next_board = board;
         next_board.do_move( move );
-        const int32_t next_depth = get_next_depth( board, next_board, depth );
-        double value = search( next_board, alpha, local_beta, next_depth );
+        double value = search_child( board, next_board, move, alpha, local_beta, depth );
         if ( worst_value > value )
         {
             worst_value = value;
             worst_move = move;
+            update_pv( move );
         }
         local_beta = std::min( local_beta, value );
     };
@@ -254,10 +382,15 @@ ExpectMinMaxStrategy::get_worst_value( const Board& board,
     if ( is_valid( board, PV ) )
     {
         process_move( PV );
+        if ( m_aborted )
+        {
+            return 0.0;
+        }
     }
 
     Move sorted_moves[ MAX_MOVES ];
     auto sorted_moves_end = board.get_sorted_moves( sorted_moves );
+    vary_order( sorted_moves, sorted_moves_end );
     for ( auto move_ptr = sorted_moves; move_ptr != sorted_moves_end; ++move_ptr )
     {
         if ( worst_value <= alpha )
@@ -282,7 +415,7 @@ ExpectMinMaxStrategy::get_worst_value( const Board& board,
     }
 
     auto entry_type = get_entry_type( worst_value, alpha, beta );
-    m_transposition_table.store( board, depth, entry_type, worst_value, worst_move );
+    store( key, depth, entry_type, worst_value, worst_move );
 
     return worst_value;
 }
@@ -294,12 +427,18 @@ ExpectMinMaxStrategy::search( const Board& board,
                               const int32_t depth,
                               Move* best_move_ptr )
 {
-    if ( m_can_abort and m_nodes >= MAX_NODES )
+    if ( m_can_abort and ( ++m_checks & DEADLINE_CHECK_MASK ) == 0 and is_stopped( ) )
     {
         m_aborted = true;
+    }
+
+    if ( m_aborted )
+    {
         return 0.0;
     }
 
+    m_pv_length[ m_ply ] = m_ply;
+
     if ( board.end_game( ) )
     {
         ++m_nodes;
@@ -327,22 +466,29 @@ ExpectMinMaxStrategy::search( const Board& board,
     double value;
     Move PV;
 
-    if ( look_in_transposition_table( board, depth, alpha, beta, value, best_move_ptr, PV ) )
+    const uint64_t key = board.get_key( ) ^ m_key_salt;
+    if ( look_in_transposition_table( key, depth, alpha, beta, value, best_move_ptr, PV ) )
     {
         return value;
     }
 
+    //! The best line of the previous depth is tried first, whatever the table kept
+    if ( m_on_line and m_ply < static_cast< int32_t >( m_line.size( ) ) )
+    {
+        PV = m_line[ m_ply ];
+    }
+
     if ( board.get_player( ) == m_player )
     {
-        return get_best_value( board, alpha, beta, depth, PV, best_move_ptr );
+        return get_best_value( board, key, alpha, beta, depth, PV, best_move_ptr );
     }
     else if ( board.get_player( ) == m_teammate )
     {
-        return get_average_value( board, alpha, beta, depth );
+        return get_average_value( board, key, alpha, beta, depth );
     }
     else
     {
-        return get_worst_value( board, alpha, beta, depth, PV );
+        return get_worst_value( board, key, alpha, beta, depth, PV );
     }
 }
 
@@ -351,12 +497,32 @@ ExpectMinMaxStrategy::get_best_action( const Board& board )
 {
     std::cerr << "Using ExpectMinMaxStrategy\n";
 
-    double last_total_time = 0.0;
-    double total_time = 0.0;
-    const double max_turn_time = Timer::get_max_time( board );
+    //! Each depth starts from the best line of the previous one, the last completed depth
+    //! gives the action when the deadline aborts the current one
+    const double max_turn_time = m_context.get_max_turn_time( board );
+    Timer turn_timer;
+    m_deadline.set_alarm( static_cast< int32_t >( 1e6 * max_turn_time ) );
+    m_line.clear( );
+    m_turn_nodes = 0;
+    m_transposition_table.new_generation( );
+
+    const int32_t threads = std::max( m_context.threads, 1 );
+    std::atomic< bool > stop( false );
+    std::vector< std::unique_ptr< ExpectMinMaxStrategy > > helpers;
+    ThreadPool::Group group;
+    for ( int32_t helper = 1; helper < threads; ++helper )
+    {
+        helpers.emplace_back( new ExpectMinMaxStrategy( m_context, m_player ) );
+        auto& strategy = *helpers.back( );
+        ThreadPool::get( ).submit(
+            [&strategy, &board, &stop, helper]( ) {
+                strategy.search_as_helper( board, helper, stop );
+            },
+            group );
+    }
 
-    int32_t depth = START_DEPTH;
-    for ( ; depth <= MAX_DEPTH; ++depth )
+    m_completed_depth = 0;
+    for ( int32_t depth = START_DEPTH; depth <= MAX_DEPTH; ++depth )
     {
         m_can_abort = depth > MIN_DEPTH;
         Move best_move = INVALID_MOVE;
@@ -364,11 +530,12 @@ ExpectMinMaxStrategy::get_best_action( const Board& board )
         Timer timer;
         double value = search( board, -OO, +OO, depth, &best_move );
         timer.stop( );
-        double dt = timer.get_delta_time( );
-        total_time += dt;
+        turn_timer.stop( );
+        m_context.add_time( timer );
+        m_turn_nodes += m_nodes;
         std::cerr << "\td=" << depth << " v=" << value << " n=" << m_nodes << " c=" << m_cutoff
-                  << " dt=" << dt << " tt=" << total_time << " ttt=" << timer.get_total_time( )
-                  << "\n";
+                  << " dt=" << timer.get_delta_time( ) << " ttd=" << turn_timer.get_delta_time( )
+                  << " ttt=" << m_context.get_total_time( ) << "\n";
 
         if ( m_aborted )
         {
@@ -376,55 +543,78 @@ ExpectMinMaxStrategy::get_best_action( const Board& board )
             break;
         }
 
-        if ( depth >= MIN_DEPTH )
-        {
-            double branching_factor = DEFAULT_BRANCHING_FACTOR;
-            if ( last_total_time > 0 )
-            {
-                branching_factor = total_time;
-                branching_factor /= last_total_time;
-            }
+        m_completed_depth = depth;
+        m_line.assign( m_pv[ 0 ], m_pv[ 0 ] + m_pv_length[ 0 ] );
 
-            if ( branching_factor * total_time >= max_turn_time )
-            {
-                break;
-            }
+        if ( m_line.empty( )
+             or turn_timer.get_delta_time( ) >= NEXT_DEPTH_TIME_SHARE * max_turn_time )
+        {
+            break;
         }
+    }
+
+    m_deadline.clear_alarm( );
+    stop = true;
+    ThreadPool::get( ).wait( group );
+    turn_timer.stop( );
 
-        last_total_time = total_time;
+    //! Node rate of all the threads, the depths reached by the helpers show the time-to-depth
+    //! gained by the sharing
+    int64_t nodes = m_turn_nodes;
+    for ( const auto& helper : helpers )
+    {
+        std::cerr << "\thelper=" << helper->m_helper << " d=" << helper->m_completed_depth
+                  << " n=" << helper->m_turn_nodes << "\n";
+        nodes += helper->m_turn_nodes;
     }
 
-    std::cerr << "Constructing best moves list\n";
+    std::cerr << "\tthreads=" << threads << " n=" << nodes
+              << " nps=" << nodes / turn_timer.get_delta_time( ) << "\n";
+    std::cerr << "\ttable=" << m_transposition_table.get_size( )
+              << " usage=" << m_transposition_table.get_usage( ) << "\n";
 
-    if ( m_aborted or depth > MAX_DEPTH )
+    //! Our moves are the first ones of the principal variation
+    Action best_action;
+    Board next_board = board;
+    bool passed = false;
+    for ( const auto move : m_line )
     {
-        --depth;
+        if ( next_board.get_player( ) != m_player or best_action.full( ) )
+        {
+            break;
+        }
+
+        if ( move == NIL_MOVE )
+        {
+            passed = true;
+            break;
+        }
+
+        best_action.push_back( move );
+        next_board.do_move( move );
     }
 
+    //! A table hit may have cut the variation short, the missing moves are searched again
     m_can_abort = false;
-    Action best_action;
-    for ( Board next_board = board; next_board.get_player( ) == m_player; )
+    m_line.clear( );
+    while ( not passed and next_board.get_player( ) == m_player and not best_action.full( ) )
     {
         Move best_move = INVALID_MOVE;
         init_search( );
         Timer timer;
-        double value = search( next_board, -OO, +OO, depth, &best_move );
+        double value = search( next_board, -OO, +OO, m_completed_depth, &best_move );
         timer.stop( );
-        double dt = timer.get_delta_time( );
-        total_time += dt;
-        std::cerr << "\td=" << depth << " v=" << value << " n=" << m_nodes << " c=" << m_cutoff
-                  << " dt=" << dt << " tt=" << total_time << " ttt=" << timer.get_total_time( )
-                  << std::endl;
+        m_context.add_time( timer );
+        std::cerr << "\tcompleting d=" << m_completed_depth << " v=" << value << " n=" << m_nodes
+                  << " dt=" << timer.get_delta_time( ) << "\n";
 
-        if ( best_move != NIL_MOVE )
-        {
-            best_action.push_back( best_move );
-            next_board.do_move( best_move );
-        }
-        else
+        if ( best_move == NIL_MOVE or best_move == INVALID_MOVE )
         {
             break;
         }
+
+        best_action.push_back( best_move );
+        next_board.do_move( best_move );
     }
 
     std::cerr << Conversion::action_to_string( best_action ) << std::endl;
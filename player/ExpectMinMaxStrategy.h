@@ -2,25 +2,64 @@
 
 #include "Board.h"
 #include "Strategy.h"
+#include "Timer.h"
 #include "TranspositionTable.h"
 
+#include <atomic>
+
+struct SearchContext;
+
+//! With several threads in the search context the search is Lazy SMP: helpers search the same
+//! position on the thread pool with shifted depths and move orders, they only share the
+//! transposition table with the main search, whose result is played.
 class ExpectMinMaxStrategy : public Strategy
 {
 public:
-    explicit ExpectMinMaxStrategy( const Board::Player player );
+    ExpectMinMaxStrategy( SearchContext& context, const Board::Player player );
     ~ExpectMinMaxStrategy( );
 
     Action get_best_action( const Board& board ) override;
 
+    //! Deepens up to the maximal depth or until stopped, the helper index varies the depths and
+    //! the move orders. Run by the helpers of get_best_action
+    void search_as_helper( const Board& board,
+                           const int32_t helper,
+                           const std::atomic< bool >& stop );
+
 private:
+    //! The test drives the searches to a given depth and reads their entries
+    friend class ExpectMinMaxStrategyTest;
+
+    //! Plies of the deepest search, up to three moves per player turn
+    static const int32_t MAX_PLY = 128;
+
     void init_search( );
+    bool is_stopped( ) const;
+    //! The helpers start the searches of the first plies from another move
+    void vary_order( Move* sorted_moves, Move* sorted_moves_end ) const;
+    //! Searches a child, following the best line of the previous depth while the moves match
+    double search_child( const Board& board,
+                         const Board& next_board,
+                         const Move move,
+                         const double alpha,
+                         const double beta,
+                         const int32_t depth );
+    //! Makes the move followed by the variation of the searched child the variation of the
+    //! current ply
+    void update_pv( const Move move );
     double search( const Board& board,
                    const double min_value,
                    const double max_value,
                    const int32_t depth,
                    Move* best_move_ptr = nullptr );
 
-    bool look_in_transposition_table( const Board& board,
+    //! Stores the value of a node unless the search was aborted
+    void store( const uint64_t key,
+                const int32_t depth,
+                const Entry::Type type,
+                const double value,
+                const Move move );
+    bool look_in_transposition_table( const uint64_t key,
                                       const int32_t depth,
                                       double& alpha,
                                       double& beta,
@@ -29,6 +68,7 @@ private:
                                       Move& PV );
 
     double get_best_value( const Board& board,
+                           const uint64_t key,
                            const double alpha,
                            const double beta,
                            const int32_t depth,
@@ -36,21 +76,46 @@ private:
                            Move* best_move_ptr );
 
     double get_average_value( const Board& board,
+                              const uint64_t key,
                               const double alpha,
                               const double beta,
                               const int32_t depth );
 
     double get_worst_value( const Board& board,
+                            const uint64_t key,
                             const double alpha,
                             const double beta,
                             const int32_t depth,
                             const Move PV );
 
+    SearchContext& m_context;
     Board::Player m_player;
     Board::Player m_teammate;
+    //! Mixed into the keys: the values of the table are seen from m_player, and the strategies
+    //! of the other players may search with the same context
+    uint64_t m_key_salt;
     int32_t m_nodes;
+    //! Nodes of all the depths of the turn
+    int64_t m_turn_nodes;
+    int32_t m_completed_depth;
+    //! 0 for the main search
+    int32_t m_helper;
+    //! Set by the main search when the helpers must stop, null in the main search
+    const std::atomic< bool >* m_stop;
     int32_t m_cutoff;
+    int32_t m_checks;
+    //! Moves from the root to the searched board
+    int32_t m_ply;
+    //! Set while the moves from the root are the first ones of m_line
+    bool m_on_line;
     bool m_can_abort;
     bool m_aborted;
-    TranpositionTable m_transposition_table;
+    //! Principal variation of the last completed depth
+    std::vector< Move > m_line;
+    //! Triangular table: the variation found at a ply starts at its own index of its row
+    Move m_pv[ MAX_PLY ][ MAX_PLY ];
+    int32_t m_pv_length[ MAX_PLY ];
+    //! Alarm at the end of the time of the turn
+    Timer m_deadline;
+    TranspositionTable& m_transposition_table;
 };
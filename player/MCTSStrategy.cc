@@ -4,19 +4,14 @@
 #include "Conversion.h"
 #include "MCTSStrategy.h"
 #include "Node.h"
+#include "SearchContext.h"
+#include "ThreadPool.h"
 #include "Timer.h"
 
 namespace
 {
 const int32_t MAX_LEVEL = 4;
 
-Move
-get_default_policy_move( const Board& board )
-{
-    // TODO: prevent next player jumps
-    return board.get_random_move( );
-}
-
 bool
 check_consistency( Node* root )
 {
@@ -43,7 +38,8 @@ extract_best_action( Node* root )
     const auto player = root->player;
 
     Action best_action;
-    for ( auto node = root; not node->is_leaf and node->player == player; )
+    for ( auto node = root;
+          not node->is_leaf and node->player == player and not best_action.full( ); )
     {
         node = node->select_most_visited( );
         if ( node->move != NIL_MOVE )
@@ -59,6 +55,38 @@ extract_best_action( Node* root )
     return best_action;
 }
 
+void
+add_child_stats( const Node* node,
+                 const Board::Player player,
+                 std::vector< Move >& path,
+                 MCTSStrategy::PathStats& stats )
+{
+    if ( node->is_leaf or node->player != player or path.size( ) == MAX_ACTION_MOVES )
+    {
+        return;
+    }
+
+    for ( const auto child : node->children )
+    {
+        path.push_back( child->move );
+        auto& path_stats = stats[ path ];
+        const int32_t visits = path_stats.visits + child->visits;
+        if ( visits > 0 )
+        {
+            path_stats.value
+                = ( path_stats.value * path_stats.visits + child->value * child->visits ) / visits;
+            path_stats.visits = visits;
+        }
+
+        if ( child->move != NIL_MOVE )
+        {
+            add_child_stats( child, player, path, stats );
+        }
+
+        path.pop_back( );
+    }
+}
+
 void
 log_expected_variation( Node* root )
 {
@@ -99,8 +127,10 @@ get_adapted_score( const double score )
 }
 }
 
-MCTSStrategy::MCTSStrategy( const Board::Player player )
-    : m_player( player )
+MCTSStrategy::MCTSStrategy( SearchContext& context, const Board::Player player )
+    : m_context( context )
+    , m_player( player )
+    , m_report_interval( 0 )
 {
 }
 
@@ -108,21 +138,69 @@ MCTSStrategy::~MCTSStrategy( )
 {
 }
 
+void
+MCTSStrategy::set_report( const int32_t interval, const Report& report )
+{
+    m_report_interval = interval;
+    m_report = report;
+}
+
+void
+MCTSStrategy::add_path_stats( const Node* root, PathStats& stats )
+{
+    std::vector< Move > path;
+    add_child_stats( root, root->player, path, stats );
+}
+
+Action
+MCTSStrategy::select_action( const PathStats& stats )
+{
+    Action action;
+    std::vector< Move > path;
+    while ( not action.full( ) )
+    {
+        Move best_move = INVALID_MOVE;
+        int32_t max_visits = 0;
+        for ( const auto& entry : stats )
+        {
+            const auto& moves = entry.first;
+            if ( moves.size( ) == path.size( ) + 1
+                 and std::equal( path.cbegin( ), path.cend( ), moves.cbegin( ) )
+                 and max_visits < entry.second.visits )
+            {
+                max_visits = entry.second.visits;
+                best_move = moves.back( );
+            }
+        }
+
+        if ( best_move == INVALID_MOVE or best_move == NIL_MOVE )
+        {
+            break;
+        }
+
+        action.push_back( best_move );
+        path.push_back( best_move );
+    }
+
+    return action;
+}
+
 double
-MCTSStrategy::run_simulation( Board& board,
+MCTSStrategy::run_simulation( SearchContext& context,
+                              Board& board,
                               const int32_t max_turns,
                               std::vector< PlayerMove >& moves )
 {
     while ( board.get_turns( ) < max_turns and not board.is_running( ) )
     {
         const auto player = board.get_player( );
-        const auto default_policy_move = get_default_policy_move( board );
+        // TODO: prevent next player jumps
+        const auto default_policy_move = board.do_random_move( context.random );
         if ( default_policy_move == INVALID_MOVE )
         {
             break;
         }
 
-        board.do_move( default_policy_move );
         moves.emplace_back( player, default_policy_move );
     }
 
@@ -130,20 +208,16 @@ MCTSStrategy::run_simulation( Board& board,
     return get_adapted_score( score );
 }
 
-Action
-MCTSStrategy::get_best_action( const Board& board )
+Node*
+MCTSStrategy::search_tree( SearchContext& context, const Board& board, int32_t& iteration )
 {
-    Timer timer;
-
-    std::cerr << "Using MCTSStrategy\n";
-
-    Node* root = new Node( board );
+    Node* root = new Node( context, board );
 
     const int32_t max_iterations = 30000;
     const int32_t max_check_iterations = 32000;
     const int32_t turns = board.get_turns( );
     const int32_t max_turns = std::min( 80, 4 * ( turns / 4 ) + 16 );
-    int32_t iteration = 0;
+    iteration = 0;
     for ( ;; ++iteration )
     {
         auto node = root;
@@ -168,7 +242,7 @@ MCTSStrategy::get_best_action( const Board& board )
         }
 
         // simulation
-        const double value = run_simulation( tmp_board, max_turns, moves );
+        const double value = run_simulation( context, tmp_board, max_turns, moves );
 
         // back propagate
         while ( node != nullptr )
@@ -188,6 +262,12 @@ MCTSStrategy::get_best_action( const Board& board )
             node = node->parent;
         }
 
+        if ( m_report and &context == &m_context and iteration > 0
+             and iteration % m_report_interval == 0 )
+        {
+            m_report( root, iteration );
+        }
+
         if ( iteration >= max_iterations and check_consistency( root ) )
         {
             break;
@@ -199,7 +279,66 @@ MCTSStrategy::get_best_action( const Board& board )
         }
     }
 
-    const auto best_action = extract_best_action( root );
+    if ( m_report and &context == &m_context )
+    {
+        m_report( root, iteration );
+    }
+
+    return root;
+}
+
+Action
+MCTSStrategy::get_best_action( const Board& board )
+{
+    Timer timer;
+
+    std::cerr << "Using MCTSStrategy\n";
+
+    //! The first tree is searched here, the others by the pool, each one in its own context
+    const int32_t trees = std::max( m_context.threads, 1 );
+    while ( static_cast< int32_t >( m_context.tree_contexts.size( ) ) < trees - 1 )
+    {
+        m_context.tree_contexts.emplace_back( new SearchContext( ) );
+    }
+
+    std::vector< Node* > roots( trees );
+    std::vector< int32_t > iterations( trees );
+    ThreadPool::Group group;
+    for ( int32_t tree = 1; tree < trees; ++tree )
+    {
+        auto& context = *m_context.tree_contexts[ tree - 1 ];
+        context.random.seed( m_context.random.pick( ) );
+        ThreadPool::get( ).submit(
+            [this, &context, &board, &roots, &iterations, tree]( ) {
+                roots[ tree ] = search_tree( context, board, iterations[ tree ] );
+            },
+            group );
+    }
+
+    Node* root = roots.front( ) = search_tree( m_context, board, iterations.front( ) );
+    int32_t iteration = iterations.front( );
+    if ( trees > 1 )
+    {
+        ThreadPool::get( ).wait( group );
+        std::cerr << "\ttrees=" << trees << " i="
+                  << std::accumulate( iterations.cbegin( ), iterations.cend( ), 0 ) << "\n";
+    }
+
+    Action best_action;
+    if ( trees > 1 )
+    {
+        PathStats stats;
+        for ( const auto tree_root : roots )
+        {
+            add_path_stats( tree_root, stats );
+        }
+
+        best_action = select_action( stats );
+    }
+    else
+    {
+        best_action = extract_best_action( root );
+    }
     log_expected_variation( root );
 
     auto most_visited = root->select_most_visited( );
@@ -210,12 +349,17 @@ MCTSStrategy::get_best_action( const Board& board )
               << ", " << mc_stats.value << ") rave=(" << rave_stats.visits << ", "
               << rave_stats.value << ")\n";
 
-    Node::clear_all_nodes( );
+    m_context.clear_nodes( );
+    for ( int32_t tree = 1; tree < trees; ++tree )
+    {
+        m_context.tree_contexts[ tree - 1 ]->clear_nodes( );
+    }
 
     timer.stop( );
+    m_context.add_time( timer );
 
-    std::cerr << "\tdt=" << timer.get_delta_time( ) << " tt=" << timer.get_total_time( ) << "\n\t"
-              << Conversion::action_to_string( best_action ) << std::endl;
+    std::cerr << "\tdt=" << timer.get_delta_time( ) << " tt=" << m_context.get_total_time( )
+              << "\n\t" << Conversion::action_to_string( best_action ) << std::endl;
 
     return best_action;
 }
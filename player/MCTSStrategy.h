@@ -1,16 +1,34 @@
 #pragma once
 
 #include "Board.h"
+#include "Node.h"
 #include "Strategy.h"
 
+#include <functional>
+
+struct SearchContext;
+
 class MCTSStrategy : public Strategy
 {
 public:
-    explicit MCTSStrategy( const Board::Player player );
+    MCTSStrategy( SearchContext& context, const Board::Player player );
     ~MCTSStrategy( );
 
     Action get_best_action( const Board& board ) override;
 
+    //! Visits and value of the moves of the searching player below the root, keyed by the moves
+    //! leading to them from the root
+    using PathStats = std::map< std::vector< Move >, Node::Stats >;
+    //! Called with the first tree every interval iterations and once when it is grown
+    using Report = std::function< void( const Node* root, const int32_t iteration ) >;
+
+    void set_report( const int32_t interval, const Report& report );
+
+    //! Adds the stats of a tree, the values are averaged over the visits
+    static void add_path_stats( const Node* root, PathStats& stats );
+    //! Follows the most visited moves of the stats while the searching player keeps the turn
+    static Action select_action( const PathStats& stats );
+
 private:
     struct PlayerMove
     {
@@ -24,9 +42,15 @@ private:
         Move move;
     };
 
-    double run_simulation( Board& board,
+    double run_simulation( SearchContext& context,
+                           Board& board,
                            const int32_t max_turns,
                            std::vector< PlayerMove >& moves );
+    //! Grows one tree with the nodes and random numbers of the context, returns its root
+    Node* search_tree( SearchContext& context, const Board& board, int32_t& iteration );
 
+    SearchContext& m_context;
     Board::Player m_player;
+    int32_t m_report_interval;
+    Report m_report;
 };
@@ -2,7 +2,7 @@
 
 #include "Board.h"
 #include "Node.h"
-#include "RandomNumberGenerator.h"
+#include "SearchContext.h"
 
 namespace
 {
@@ -10,10 +10,23 @@ const double UCTK = 0.1;
 
 constexpr int MAX_VISITS = 32000;
 
-double SQRT_LOG[ MAX_VISITS ];
-double SQRT[ MAX_VISITS ];
+//! Only read once built, so all the searches share them
+struct SquareRoots
+{
+    SquareRoots( )
+    {
+        for ( auto v = 0; v < MAX_VISITS; ++v )
+        {
+            sqrt_log[ v ] = std::sqrt( std::log( v ) );
+            sqrt[ v ] = std::sqrt( v );
+        }
+    }
 
-std::list< Node* > allocated_nodes;
+    double sqrt_log[ MAX_VISITS ];
+    double sqrt[ MAX_VISITS ];
+};
+
+const SquareRoots square_roots;
 
 void
 update_stats( Node::Stats& stats, const double new_value )
@@ -23,59 +36,16 @@ update_stats( Node::Stats& stats, const double new_value )
     value = ( value * visits + new_value ) / ( visits + 1 );
     visits += 1;
 }
-
-uint64_t
-get_combined_hash( const uint64_t hash, const uint64_t lock )
-{
-    return hash | ( lock << 32 );
-}
-
-void
-destroy_allocated_nodes( )
-{
-    for ( Node* node : allocated_nodes )
-    {
-        delete node;
-    }
-
-    allocated_nodes.clear( );
-}
-
-std::vector< Node::SharedStats > shared_stats{MAX_VISITS};
-Node::SharedStats* next_shared_stats = &shared_stats.front( );
-std::unordered_map< uint64_t, Node::SharedStats* > shared_stats_map{MAX_VISITS};
-
-int32_t transpositions = 0;
-Node::SharedStats*
-get_or_create_shared_stats( const Board& board, bool& new_stats )
-{
-    const uint64_t hash = board.get_hash( );
-    const uint64_t lock = board.get_lock( );
-    const uint64_t combined_hash = get_combined_hash( hash, lock );
-    const auto iterator = shared_stats_map.find( combined_hash );
-    if ( iterator != shared_stats_map.cend( ) )
-    {
-        ++transpositions;
-        new_stats = false;
-        return iterator->second;
-    }
-
-    new_stats = true;
-    Node::SharedStats* stats = next_shared_stats++;
-    stats->mc = Node::Stats{};
-    stats->rave.clear( );
-    shared_stats_map.emplace( combined_hash, stats );
-
-    return stats;
-}
 }
 
-Node::Node( const Board& board,
+Node::Node( SearchContext& search_context,
+            const Board& board,
             const Move move,
             Node* parent,
             const double weight,
             const double bias )
-    : player( board.get_player( ) )
+    : context( &search_context )
+    , player( board.get_player( ) )
     , move( move )
     , parent( parent )
     , weight( weight )
@@ -98,7 +68,7 @@ Node::Node( const Board& board,
     }
 
     bool new_stats;
-    stats = get_or_create_shared_stats( board, new_stats );
+    stats = context->get_or_create_shared_stats( board, new_stats );
 
     if ( not board.end_game( ) )
     {
@@ -123,7 +93,7 @@ Node::Node( const Board& board,
         }
     }
 
-    allocated_nodes.push_back( this );
+    context->nodes.push_back( this );
 }
 
 Node::~Node( )
@@ -140,7 +110,7 @@ Node::expand( Board& board )
     double delta_score = board.get_score( player ) - score;
     const double weight = std::pow( 16.0, delta_score );
     const double bias = 0.05 * delta_score;
-    auto child = new Node( board, move, this, weight, bias );
+    auto child = new Node( *context, board, move, this, weight, bias );
     children.emplace_back( child );
 
     return child;
@@ -149,7 +119,8 @@ Node::expand( Board& board )
 double
 Node::get_exploration_bonus( const Node* child ) const
 {
-    return UCTK * SQRT_LOG[ visits ] / SQRT[ child->visits ] + child->bias / child->visits;
+    return UCTK * square_roots.sqrt_log[ visits ] / square_roots.sqrt[ child->visits ]
+           + child->bias / child->visits;
 }
 
 void
@@ -226,7 +197,7 @@ Node::select_randomly( )
         ++weighted_children_end;
     }
 
-    const auto random_weight = RandomNumberGenerator::pick( sum_weights );
+    const auto random_weight = context->random.pick( sum_weights );
     const WeightedChild* iterator = std::upper_bound( weighted_children, weighted_children_end,
                                                       WeightedChild{random_weight, nullptr} );
 
@@ -309,22 +280,3 @@ Node::is_fully_expanded( ) const
 {
     return untried_moves.empty( );
 }
-
-void
-Node::init_data( )
-{
-    for ( auto v = 0; v < MAX_VISITS; ++v )
-    {
-        SQRT_LOG[ v ] = std::sqrt( std::log( v ) );
-        SQRT[ v ] = std::sqrt( v );
-    }
-}
-
-void
-Node::clear_all_nodes( )
-{
-    destroy_allocated_nodes( );
-    next_shared_stats = &shared_stats.front( );
-    std::cerr << "\ttc=" << transpositions << std::endl;
-    transpositions = 0;
-}
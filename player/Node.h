@@ -3,6 +3,8 @@
 #include "Board.h"
 #include "Common.h"
 
+struct SearchContext;
+
 struct Node
 {
     struct Stats
@@ -23,7 +25,8 @@ struct Node
         std::unordered_map< Move, Stats > rave;
     };
 
-    Node( const Board& board,
+    Node( SearchContext& search_context,
+          const Board& board,
           const Move move = INVALID_MOVE,
           Node* parent = nullptr,
           const double weight = 0.0,
@@ -43,6 +46,8 @@ struct Node
     void rave_update( const Board::Player player, const Move move, const double new_value );
     bool is_fully_expanded( ) const;
 
+    //! Owns the node, its stats and the random numbers of the search
+    SearchContext* context;
     int32_t level;
     Board::Player player;
     Move move;
@@ -55,7 +60,4 @@ struct Node
     std::list< Move > untried_moves;
     bool is_leaf;
     SharedStats* stats;
-
-    static void init_data( );
-    static void clear_all_nodes( );
 };
@@ -0,0 +1,70 @@
+#include "Common.h"
+
+#include "PlayoutBatch.h"
+
+#include "RandomNumberGenerator.h"
+
+PlayoutBatch::PlayoutBatch( RandomNumberGenerator& random, const Board::Player player )
+    : m_random( random )
+    , m_player( player )
+{
+}
+
+PlayoutBatch::~PlayoutBatch( )
+{
+}
+
+bool
+PlayoutBatch::is_over( const Board& board, const int32_t max_turns )
+{
+    return board.get_turns( ) >= max_turns or board.is_running( );
+}
+
+void
+PlayoutBatch::run( Board boards[], const int32_t count, const int32_t max_turns, double scores[] )
+{
+    m_lanes.clear( );
+    for ( int32_t lane = 0; lane < count; ++lane )
+    {
+        if ( not is_over( boards[ lane ], max_turns ) )
+        {
+            m_lanes.push_back( lane );
+        }
+    }
+
+    while ( not m_lanes.empty( ) )
+    {
+        //! Generation: the child Store entries of all the lanes are requested at once
+        m_iterators.clear( );
+        for ( const auto lane : m_lanes )
+        {
+            m_iterators.emplace_back( boards[ lane ] );
+            m_iterators.back( ).prefetch( );
+        }
+
+        //! Sampling and application, finished lanes are dropped
+        size_t active = 0;
+        for ( size_t i = 0; i < m_lanes.size( ); ++i )
+        {
+            const auto lane = m_lanes[ i ];
+            const auto move = m_iterators[ i ].random_move( m_random );
+            if ( move == INVALID_MOVE )
+            {
+                continue;
+            }
+
+            boards[ lane ].do_move( move );
+            if ( not is_over( boards[ lane ], max_turns ) )
+            {
+                m_lanes[ active++ ] = lane;
+            }
+        }
+
+        m_lanes.resize( active );
+    }
+
+    for ( int32_t lane = 0; lane < count; ++lane )
+    {
+        scores[ lane ] = boards[ lane ].get_score( m_player );
+    }
+}
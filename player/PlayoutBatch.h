@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Board.h"
+
+class RandomNumberGenerator;
+
+//! Plays random games on many boards in lockstep. Each step first generates the moves of
+//! every lane and prefetches their Store entries, then samples and applies one move per
+//! lane, so the cache misses of a lane overlap with the work done on the others.
+class PlayoutBatch
+{
+public:
+    PlayoutBatch( RandomNumberGenerator& random, const Board::Player player );
+    ~PlayoutBatch( );
+
+    //! Plays the boards until max_turns or until every player is running and stores the
+    //! score of the batch player for each of them
+    void run( Board boards[], const int32_t count, const int32_t max_turns, double scores[] );
+
+private:
+    static bool is_over( const Board& board, const int32_t max_turns );
+
+    RandomNumberGenerator& m_random;
+    Board::Player m_player;
+    //! Boards still playing, one iterator per lane is regenerated at every step
+    std::vector< int32_t > m_lanes;
+    std::vector< Board::MoveIterator > m_iterators;
+};
@@ -0,0 +1,119 @@
+#include "Common.h"
+
+#include "PlayoutScheduler.h"
+
+#include "RandomNumberGenerator.h"
+
+PlayoutScheduler::PlayoutScheduler( RandomNumberGenerator& random,
+                                    const Board::Player player,
+                                    const int32_t width )
+    : m_random( random )
+    , m_player( player )
+    , m_width( width )
+    , m_max_turns( 0 )
+    , m_next_lane( 0 )
+    , m_count( 0 )
+    , m_boards( nullptr )
+    , m_scores( nullptr )
+{
+}
+
+PlayoutScheduler::~PlayoutScheduler( )
+{
+}
+
+bool
+PlayoutScheduler::is_over( const Board& board ) const
+{
+    return board.get_turns( ) >= m_max_turns or board.is_running( );
+}
+
+void
+PlayoutScheduler::start( Playout& playout )
+{
+    for ( ; m_next_lane < m_count; ++m_next_lane )
+    {
+        const auto& board = m_boards[ m_next_lane ];
+        if ( is_over( board ) )
+        {
+            m_scores[ m_next_lane ] = board.get_score( m_player );
+            continue;
+        }
+
+        playout.lane = m_next_lane++;
+        playout.state = Playout::GENERATE;
+        return;
+    }
+
+    playout.state = Playout::DONE;
+}
+
+void
+PlayoutScheduler::resume( Playout& playout, Board::MoveIterator& iterator )
+{
+    auto& board = m_boards[ playout.lane ];
+
+    switch ( playout.state )
+    {
+    case Playout::GENERATE:
+        iterator = board.begin( );
+        iterator.prefetch( );
+        playout.state = Playout::APPLY;
+        break;
+    case Playout::APPLY:
+    {
+        const auto move = iterator.random_move( m_random );
+        if ( move != INVALID_MOVE )
+        {
+            board.do_move( move );
+            if ( not is_over( board ) )
+            {
+                playout.state = Playout::GENERATE;
+                break;
+            }
+        }
+
+        m_scores[ playout.lane ] = board.get_score( m_player );
+        start( playout );
+        break;
+    }
+    case Playout::DONE:
+        break;
+    }
+}
+
+void
+PlayoutScheduler::run( Board boards[],
+                       const int32_t count,
+                       const int32_t max_turns,
+                       double scores[] )
+{
+    m_boards = boards;
+    m_scores = scores;
+    m_count = count;
+    m_max_turns = max_turns;
+    m_next_lane = 0;
+
+    m_playouts.resize( m_width );
+    for ( auto& playout : m_playouts )
+    {
+        start( playout );
+    }
+
+    //! The iterators are overwritten by the first GENERATE step of each slot
+    if ( static_cast< int32_t >( m_iterators.size( ) ) != m_width )
+    {
+        m_iterators.assign( m_width, Board::MoveIterator( Board( ) ) );
+    }
+
+    for ( bool running = true; running; )
+    {
+        running = false;
+        for ( int32_t slot = 0; slot < m_width; ++slot )
+        {
+            auto& playout = m_playouts[ slot ];
+            resume( playout, m_iterators[ slot ] );
+            running = running or playout.state != Playout::DONE;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Board.h"
+
+class RandomNumberGenerator;
+
+//! Interleaves several random playouts on one core. Each playout is a small state machine
+//! suspended right after it prefetched the Store entries of its next moves; the scheduler
+//! resumes the other playouts in the meantime and refills a slot as soon as its playout ends.
+class PlayoutScheduler
+{
+public:
+    PlayoutScheduler( RandomNumberGenerator& random,
+                      const Board::Player player,
+                      const int32_t width );
+    ~PlayoutScheduler( );
+
+    //! Plays the boards until max_turns or until every player is running and stores the
+    //! score of the scheduler player for each of them
+    void run( Board boards[], const int32_t count, const int32_t max_turns, double scores[] );
+
+private:
+    struct Playout
+    {
+        enum State : uint8_t
+        {
+            GENERATE,
+            APPLY,
+            DONE
+        };
+
+        int32_t lane;
+        State state;
+    };
+
+    bool is_over( const Board& board ) const;
+    void start( Playout& playout );
+    void resume( Playout& playout, Board::MoveIterator& iterator );
+
+    RandomNumberGenerator& m_random;
+    Board::Player m_player;
+    int32_t m_width;
+    int32_t m_max_turns;
+    int32_t m_next_lane;
+    int32_t m_count;
+    Board* m_boards;
+    double* m_scores;
+    std::vector< Playout > m_playouts;
+    std::vector< Board::MoveIterator > m_iterators;
+};
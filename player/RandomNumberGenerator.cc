@@ -2,9 +2,9 @@
 
 #include "RandomNumberGenerator.h"
 
-namespace
+RandomNumberGenerator::RandomNumberGenerator( )
+    : m_engine( )
 {
-std::default_random_engine engine{};
 }
 
 void
@@ -12,10 +12,16 @@ RandomNumberGenerator::randomize( )
 {
     std::random_device rd{};
     auto s = rd( );
-    engine.seed( s );
+    m_engine.seed( s );
     std::cerr << "seed=" << s << "\n";
 }
 
+void
+RandomNumberGenerator::seed( const uint32_t seed )
+{
+    m_engine.seed( seed );
+}
+
 uint32_t
 RandomNumberGenerator::pick( const uint32_t limit_value )
 {
@@ -27,7 +33,7 @@ RandomNumberGenerator::pick( const uint32_t limit_value )
         = limit_value == 0u ? std::numeric_limits< uint32_t >::max( ) : limit_value - 1u;
     const IntDistribution::param_type parameter{min_value, max_value};
 
-    return distribution( engine, parameter );
+    return distribution( m_engine, parameter );
 }
 
 double
@@ -38,5 +44,5 @@ RandomNumberGenerator::pick( const double limit_value )
     RealDistribution distribution{};
     const RealDistribution::param_type parameter{0.0, limit_value};
 
-    return distribution( engine, parameter );
+    return distribution( m_engine, parameter );
 }
@@ -1,9 +1,16 @@
 #pragma once
 
+//! Random numbers of one search, each SearchContext owns its generator
 class RandomNumberGenerator
 {
 public:
-    static void randomize( );
-    static uint32_t pick( const uint32_t limit_value = 0u );
-    static double pick( const double limit_value );
+    RandomNumberGenerator( );
+
+    void randomize( );
+    void seed( const uint32_t seed );
+    uint32_t pick( const uint32_t limit_value = 0u );
+    double pick( const double limit_value );
+
+private:
+    std::default_random_engine m_engine;
 };
@@ -3,8 +3,10 @@
 #include "RandomStrategy.h"
 
 #include "Board.h"
+#include "SearchContext.h"
 
-RandomStrategy::RandomStrategy( )
+RandomStrategy::RandomStrategy( SearchContext& context )
+    : m_context( context )
 {
 }
 
@@ -19,11 +21,11 @@ RandomStrategy::get_best_action( const Board& board )
     const auto player = board.get_player( );
     Board next_board = board;
 
-    while ( next_board.get_player( ) == player )
+    while ( next_board.get_player( ) == player and not best_action.full( ) )
     {
-        const auto random_move = next_board.get_random_move( );
+        const auto random_move = next_board.do_random_move( m_context.random );
 
-        if ( random_move != NIL_MOVE )
+        if ( random_move != NIL_MOVE and random_move != INVALID_MOVE )
         {
             best_action.push_back( random_move );
         }
@@ -31,8 +33,6 @@ RandomStrategy::get_best_action( const Board& board )
         {
             break;
         }
-
-        next_board.do_move( random_move );
     }
 
     return best_action;
@@ -2,11 +2,16 @@
 
 #include "Strategy.h"
 
+struct SearchContext;
+
 class RandomStrategy : public Strategy
 {
 public:
-    RandomStrategy( );
+    explicit RandomStrategy( SearchContext& context );
     ~RandomStrategy( );
 
     Action get_best_action( const Board& board ) override;
+
+private:
+    SearchContext& m_context;
 };
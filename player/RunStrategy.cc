@@ -2,9 +2,11 @@
 
 #include "Board.h"
 #include "RunStrategy.h"
+#include "SearchContext.h"
 #include "Timer.h"
 
-RunStrategy::RunStrategy( )
+RunStrategy::RunStrategy( SearchContext& context )
+    : m_context( context )
 {
 }
 
@@ -16,6 +18,26 @@ Action
 RunStrategy::get_best_action( const Board& board )
 {
     Action best_action;
+    const auto player = board.get_player( );
+    auto next_board = board;
+    for ( const auto move : get_best_run( board ) )
+    {
+        if ( next_board.get_player( ) != player or best_action.full( ) )
+        {
+            break;
+        }
+
+        best_action.push_back( move );
+        next_board.do_move( move );
+    }
+
+    return best_action;
+}
+
+RunAction
+RunStrategy::get_best_run( const Board& board )
+{
+    RunAction best_run;
 
     Timer timer;
     board.display( );
@@ -26,14 +48,15 @@ RunStrategy::get_best_action( const Board& board )
     while ( not next_board.is_done( player ) )
     {
         auto best_move = next_board.get_best_running_move( );
-        best_action.push_back( best_move );
+        best_run.push_back( best_move );
         cost += next_board.do_move( best_move );
     }
 
     timer.stop( );
+    m_context.add_time( timer );
 
     std::cerr << "Using RunStrategy\n\tcost=" << cost << " dt=" << timer.get_delta_time( )
-              << " tt=" << Timer::get_total_time( ) << "\n";
+              << " tt=" << m_context.get_total_time( ) << "\n";
 
-    return best_action;
+    return best_run;
 }
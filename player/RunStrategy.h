@@ -3,11 +3,19 @@
 #include "Board.h"
 #include "Strategy.h"
 
+struct SearchContext;
+
 class RunStrategy : public Strategy
 {
 public:
-    RunStrategy( );
+    explicit RunStrategy( SearchContext& context );
     ~RunStrategy( );
 
     Action get_best_action( const Board& board ) override;
+
+    //! Moves taking the current player to its targets, used in solo mode
+    RunAction get_best_run( const Board& board );
+
+private:
+    SearchContext& m_context;
 };
@@ -0,0 +1,109 @@
+#include "Common.h"
+
+#include "SearchContext.h"
+
+#include "Board.h"
+#include "Timer.h"
+#include "TranspositionTable.h"
+
+namespace
+{
+//! A search never creates more nodes than its iterations
+const int32_t MAX_SHARED_STATS = 32000;
+//! Memory of the transposition table of a game
+const size_t TRANSPOSITION_TABLE_MEGABYTES = 32;
+//! Time of a whole game
+const double MAX_TOTAL_TIME = 30.0;
+
+uint64_t
+get_combined_hash( const uint64_t hash, const uint64_t lock )
+{
+    return hash | ( lock << 32 );
+}
+}
+
+SearchContext::SearchContext( )
+    : threads( 1 )
+    , shared_stats( MAX_SHARED_STATS )
+    , next_shared_stats( &shared_stats.front( ) )
+    , shared_stats_map( MAX_SHARED_STATS )
+    , transpositions( 0 )
+    , total_time( 0.0 )
+    , max_total_time( MAX_TOTAL_TIME )
+{
+}
+
+SearchContext::~SearchContext( )
+{
+    for ( Node* node : nodes )
+    {
+        delete node;
+    }
+}
+
+Node::SharedStats*
+SearchContext::get_or_create_shared_stats( const Board& board, bool& new_stats )
+{
+    const uint64_t hash = board.get_hash( );
+    const uint64_t lock = board.get_lock( );
+    const uint64_t combined_hash = get_combined_hash( hash, lock );
+    const auto iterator = shared_stats_map.find( combined_hash );
+    if ( iterator != shared_stats_map.cend( ) )
+    {
+        ++transpositions;
+        new_stats = false;
+        return iterator->second;
+    }
+
+    new_stats = true;
+    Node::SharedStats* stats = next_shared_stats++;
+    stats->mc = Node::Stats{};
+    stats->rave.clear( );
+    shared_stats_map.emplace( combined_hash, stats );
+
+    return stats;
+}
+
+void
+SearchContext::clear_nodes( )
+{
+    for ( Node* node : nodes )
+    {
+        delete node;
+    }
+
+    nodes.clear( );
+    next_shared_stats = &shared_stats.front( );
+    std::cerr << "\ttc=" << transpositions << std::endl;
+    transpositions = 0;
+}
+
+TranspositionTable&
+SearchContext::get_transposition_table( )
+{
+    if ( not transposition_table )
+    {
+        transposition_table.reset( new TranspositionTable( TRANSPOSITION_TABLE_MEGABYTES ) );
+    }
+
+    return *transposition_table;
+}
+
+void
+SearchContext::add_time( Timer& timer )
+{
+    total_time += timer.get_delta_time( );
+}
+
+double
+SearchContext::get_total_time( ) const
+{
+    return total_time;
+}
+
+double
+SearchContext::get_max_turn_time( const Board& board ) const
+{
+    const int32_t remaining_turns = 21 - ( board.get_turns( ) / 4 );
+    return ( max_total_time - total_time ) / remaining_turns;
+}
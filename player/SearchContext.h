@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Node.h"
+#include "RandomNumberGenerator.h"
+
+class Board;
+class Timer;
+class TranspositionTable;
+
+//! All the mutable state of the searches of one game: random numbers, nodes, shared stats,
+//! counters and time budget. Searches running at the same time each need their own context.
+struct SearchContext
+{
+    SearchContext( );
+    ~SearchContext( );
+
+    SearchContext( const SearchContext& ) = delete;
+    SearchContext& operator=( const SearchContext& ) = delete;
+
+    //! Stats shared by the nodes of the same position
+    Node::SharedStats* get_or_create_shared_stats( const Board& board, bool& new_stats );
+    //! Frees the nodes of the last search
+    void clear_nodes( );
+    //! Created on first use, then kept for the rest of the game
+    TranspositionTable& get_transposition_table( );
+
+    //! Adds the time measured by a stopped timer to the time used by the game
+    void add_time( Timer& timer );
+    double get_total_time( ) const;
+    //! Share of the remaining time of the game given to the current turn
+    double get_max_turn_time( const Board& board ) const;
+
+    RandomNumberGenerator random;
+
+    //! Threads of a search: MCTS trees searched in parallel, the first one uses this context,
+    //! or ExpectMinMax searchers sharing the transposition table
+    int32_t threads;
+    //! Contexts of the other trees, created on first use and kept across the turns
+    std::vector< std::unique_ptr< SearchContext > > tree_contexts;
+
+    std::vector< Node* > nodes;
+    std::vector< Node::SharedStats > shared_stats;
+    Node::SharedStats* next_shared_stats;
+    std::unordered_map< uint64_t, Node::SharedStats* > shared_stats_map;
+    int32_t transpositions;
+    std::unique_ptr< TranspositionTable > transposition_table;
+
+    double total_time;
+    double max_total_time;
+};
@@ -0,0 +1,131 @@
+#include "Common.h"
+
+#include "Server.h"
+#include "SocketBuffer.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+//! Free workers of the running server, negative when there is no server
+struct Workers
+{
+    std::mutex mutex;
+    std::condition_variable released;
+    int32_t free = -1;
+} workers;
+}
+
+Server::SearchSlot::SearchSlot( )
+{
+    std::unique_lock< std::mutex > lock( workers.mutex );
+    if ( workers.free < 0 )
+    {
+        return;
+    }
+
+    workers.released.wait( lock, [] { return workers.free > 0; } );
+    --workers.free;
+}
+
+Server::SearchSlot::~SearchSlot( )
+{
+    {
+        std::lock_guard< std::mutex > lock( workers.mutex );
+        if ( workers.free < 0 )
+        {
+            return;
+        }
+
+        ++workers.free;
+    }
+
+    workers.released.notify_one( );
+}
+
+Server::Server( const std::string& socket_path,
+                const int32_t workers_count,
+                const Session& session )
+    : m_socket_path( socket_path )
+    , m_workers_count( workers_count )
+    , m_session( session )
+    , m_fd( -1 )
+{
+}
+
+Server::~Server( )
+{
+    if ( m_fd >= 0 )
+    {
+        close( m_fd );
+        unlink( m_socket_path.c_str( ) );
+    }
+}
+
+int
+Server::run( )
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if ( m_socket_path.size( ) >= sizeof( address.sun_path ) )
+    {
+        std::cerr << "Socket path too long: " << m_socket_path << "\n";
+        return 1;
+    }
+
+    std::copy( m_socket_path.begin( ), m_socket_path.end( ), address.sun_path );
+
+    m_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    unlink( m_socket_path.c_str( ) );
+    if ( m_fd < 0 or bind( m_fd, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) != 0
+         or listen( m_fd, SOMAXCONN ) != 0 )
+    {
+        std::cerr << "Cannot listen on " << m_socket_path << "\n";
+        return 1;
+    }
+
+    {
+        std::lock_guard< std::mutex > lock( workers.mutex );
+        workers.free = m_workers_count;
+    }
+
+    std::cerr << "Serving on " << m_socket_path << " with " << m_workers_count << " workers\n";
+
+    //! A session spends most of its time waiting for the other players, so each one gets its
+    //! own thread and only the searches are bounded by the workers
+    for ( int32_t session_id = 0;; ++session_id )
+    {
+        const int fd = accept( m_fd, nullptr, nullptr );
+        if ( fd < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+
+            std::cerr << "Accept failed on " << m_socket_path << "\n";
+            return 1;
+        }
+
+        std::thread( &Server::serve_session, this, fd, session_id ).detach( );
+    }
+}
+
+void
+Server::serve_session( const int fd, const int32_t session_id )
+{
+    std::cerr << "Session " << session_id << " started\n";
+
+    SocketBuffer buffer( fd );
+    std::istream in( &buffer );
+    std::ostream out( &buffer );
+    const int result = m_session( in, out );
+    out.flush( );
+    close( fd );
+
+    std::cerr << "Session " << session_id << " ended with " << result << "\n";
+}
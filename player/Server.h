@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+
+//! Serves many games from one process over a local Unix socket, each connection being one game
+//! spoken with the same protocol as stdin/stdout. Sessions share the tables of their layout and
+//! their searches share a fixed number of workers; the search state of a game lives in its
+//! session thread.
+class Server
+{
+public:
+    //! Plays one game over the streams of a connection
+    using Session = std::function< int( std::istream& in, std::ostream& out ) >;
+
+    Server( const std::string& socket_path, const int32_t workers_count, const Session& session );
+    ~Server( );
+
+    //! Accepts connections until the socket fails, returns the exit code
+    int run( );
+
+    //! Holds one of the workers for the lifetime of the slot, waiting for one to be free.
+    //! Outside of a server the slots are not limited
+    class SearchSlot
+    {
+    public:
+        SearchSlot( );
+        ~SearchSlot( );
+
+        SearchSlot( const SearchSlot& ) = delete;
+        SearchSlot& operator=( const SearchSlot& ) = delete;
+    };
+
+private:
+    void serve_session( const int fd, const int32_t session_id );
+
+    std::string m_socket_path;
+    int32_t m_workers_count;
+    Session m_session;
+    int m_fd;
+};
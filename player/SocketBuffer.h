@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cerrno>
+#include <streambuf>
+#include <sys/socket.h>
+#include <unistd.h>
+
+//! Buffered stream over a connected socket, the writes go out on flush. Once the peer is gone
+//! the writes fail without raising SIGPIPE and the reads end, which ends the session
+class SocketBuffer : public std::streambuf
+{
+public:
+    explicit SocketBuffer( const int fd )
+        : m_fd( fd )
+        , m_closed( false )
+    {
+        setg( m_input, m_input, m_input );
+        setp( m_output, m_output + BUFFER_SIZE );
+    }
+
+protected:
+    int_type
+    underflow( ) override
+    {
+        if ( m_closed )
+        {
+            return traits_type::eof( );
+        }
+
+        ssize_t count = read( m_fd, m_input, BUFFER_SIZE );
+        while ( count < 0 and errno == EINTR )
+        {
+            count = read( m_fd, m_input, BUFFER_SIZE );
+        }
+
+        if ( count <= 0 )
+        {
+            return traits_type::eof( );
+        }
+
+        setg( m_input, m_input, m_input + count );
+        return traits_type::to_int_type( *gptr( ) );
+    }
+
+    int_type
+    overflow( int_type c ) override
+    {
+        if ( sync( ) != 0 )
+        {
+            return traits_type::eof( );
+        }
+
+        if ( not traits_type::eq_int_type( c, traits_type::eof( ) ) )
+        {
+            *pptr( ) = traits_type::to_char_type( c );
+            pbump( 1 );
+        }
+
+        return traits_type::not_eof( c );
+    }
+
+    int
+    sync( ) override
+    {
+        for ( const char* data = pbase( ); data < pptr( ); )
+        {
+            const ssize_t count = send( m_fd, data, pptr( ) - data, MSG_NOSIGNAL );
+            if ( count < 0 and errno == EINTR )
+            {
+                continue;
+            }
+
+            if ( count <= 0 )
+            {
+                m_closed = m_closed or errno == EPIPE or errno == ECONNRESET;
+                return -1;
+            }
+
+            data += count;
+        }
+
+        setp( m_output, m_output + BUFFER_SIZE );
+        return 0;
+    }
+
+private:
+    static const int32_t BUFFER_SIZE = 4096;
+
+    int m_fd;
+    bool m_closed;
+    char m_input[ BUFFER_SIZE ];
+    char m_output[ BUFFER_SIZE ];
+};
@@ -0,0 +1,342 @@
+#include "Common.h"
+
+#include "ThreadPool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace
+{
+//! Yields before sleeping while the tasks of a group run elsewhere
+const int32_t WAIT_SPINS = 64;
+const int32_t WAIT_SLEEP = 50;
+
+//! Set in the worker threads, -1 elsewhere
+thread_local int32_t current_worker = -1;
+thread_local const ThreadPool* current_pool = nullptr;
+
+std::mutex pool_mutex;
+std::unique_ptr< ThreadPool > pool;
+}
+
+struct ThreadPool::Worker
+{
+    Worker( )
+        : tasks( 0 )
+        , steals( 0 )
+        , busy_time( 0 )
+    {
+    }
+
+    //! Guards the deque, the owner works at the back and the thieves at the front
+    std::mutex mutex;
+    std::deque< std::pair< Task, Group* > > queue;
+    std::thread thread;
+    std::atomic< uint64_t > tasks;
+    std::atomic< uint64_t > steals;
+    //! Microseconds spent running tasks
+    std::atomic< uint64_t > busy_time;
+};
+
+ThreadPool::Group::Group( )
+    : m_pending( 0 )
+{
+}
+
+bool
+ThreadPool::Group::done( ) const
+{
+    return m_pending.load( std::memory_order_acquire ) == 0;
+}
+
+ThreadPool::ThreadPool( const int32_t workers_count, const bool pinned )
+    : m_workers( new Worker[ std::max( workers_count, 1 ) ] )
+    , m_workers_count( std::max( workers_count, 1 ) )
+    , m_pinned( pinned )
+    , m_next_worker( 0u )
+    , m_unfinished( 0 )
+    , m_stopping( false )
+    , m_start( std::chrono::steady_clock::now( ) )
+{
+    sem_init( &m_queued, 0, 0 );
+    for ( int32_t index = 0; index < m_workers_count; ++index )
+    {
+        m_workers[ index ].thread = std::thread( &ThreadPool::run_worker, this, index );
+    }
+
+    std::cerr << "Thread pool workers = " << m_workers_count << ( m_pinned ? " pinned" : "" )
+              << "\n";
+}
+
+ThreadPool::~ThreadPool( )
+{
+    //! The remaining tasks may still submit others, the workers only stop once all are done
+    const int32_t index = current_pool == this ? current_worker : -1;
+    while ( m_unfinished.load( std::memory_order_acquire ) > 0 )
+    {
+        if ( sem_trywait( &m_queued ) == 0 )
+        {
+            run_one( index );
+        }
+        else
+        {
+            std::this_thread::yield( );
+        }
+    }
+
+    m_stopping = true;
+    for ( int32_t index = 0; index < m_workers_count; ++index )
+    {
+        sem_post( &m_queued );
+    }
+
+    for ( int32_t index = 0; index < m_workers_count; ++index )
+    {
+        m_workers[ index ].thread.join( );
+    }
+
+    sem_destroy( &m_queued );
+}
+
+void
+ThreadPool::submit( const Task& task, Group& group )
+{
+    const int32_t index = current_pool == this
+                              ? current_worker
+                              : static_cast< int32_t >( m_next_worker++ % m_workers_count );
+
+    group.m_pending.fetch_add( 1, std::memory_order_relaxed );
+    m_unfinished.fetch_add( 1, std::memory_order_relaxed );
+    {
+        std::lock_guard< std::mutex > lock( m_workers[ index ].mutex );
+        m_workers[ index ].queue.emplace_back( task, &group );
+    }
+
+    sem_post( &m_queued );
+}
+
+void
+ThreadPool::wait( Group& group )
+{
+    const int32_t index = current_pool == this ? current_worker : -1;
+    for ( int32_t spins = 0; not group.done( ); )
+    {
+        if ( help( index, group ) )
+        {
+            spins = 0;
+        }
+        else if ( ++spins < WAIT_SPINS )
+        {
+            std::this_thread::yield( );
+        }
+        else
+        {
+            usleep( WAIT_SLEEP );
+        }
+    }
+}
+
+int32_t
+ThreadPool::get_workers_count( ) const
+{
+    return m_workers_count;
+}
+
+ThreadPool::Utilization
+ThreadPool::get_utilization( const int32_t worker ) const
+{
+    const auto& data = m_workers[ worker ];
+    return Utilization{data.tasks.load( ), data.steals.load( ), 1e-6 * data.busy_time.load( )};
+}
+
+void
+ThreadPool::log_utilization( ) const
+{
+    const std::chrono::duration< double > uptime = std::chrono::steady_clock::now( ) - m_start;
+    for ( int32_t index = 0; index < m_workers_count; ++index )
+    {
+        const auto utilization = get_utilization( index );
+        std::cerr << "\tworker=" << index << " tasks=" << utilization.tasks
+                  << " steals=" << utilization.steals << " busy="
+                  << 100.0 * utilization.busy_time / uptime.count( ) << "%\n";
+    }
+}
+
+void
+ThreadPool::init( const int32_t workers_count, const bool pinned )
+{
+    std::lock_guard< std::mutex > lock( pool_mutex );
+    if ( not pool )
+    {
+        pool.reset( new ThreadPool( workers_count, pinned ) );
+    }
+}
+
+ThreadPool&
+ThreadPool::get( )
+{
+    std::lock_guard< std::mutex > lock( pool_mutex );
+    if ( not pool )
+    {
+        pool.reset( new ThreadPool( std::thread::hardware_concurrency( ), false ) );
+    }
+
+    return *pool;
+}
+
+void
+ThreadPool::run_worker( const int32_t index )
+{
+    current_worker = index;
+    current_pool = this;
+    if ( m_pinned )
+    {
+        pin( index );
+    }
+
+    for ( ;; )
+    {
+        while ( sem_wait( &m_queued ) != 0 )
+        {
+            //! Interrupted by a signal
+        }
+
+        if ( m_stopping )
+        {
+            break;
+        }
+
+        run_one( index );
+    }
+}
+
+void
+ThreadPool::run_one( const int32_t index )
+{
+    Task task;
+    Group* group = nullptr;
+    //! The token guarantees a queued task, it may be taken from a deque already visited
+    while ( not pop( index, nullptr, task, group ) )
+    {
+    }
+
+    run( index, task, *group );
+}
+
+bool
+ThreadPool::help( const int32_t index, Group& group )
+{
+    if ( sem_trywait( &m_queued ) != 0 )
+    {
+        return false;
+    }
+
+    Task task;
+    Group* popped = nullptr;
+    if ( not pop( index, &group, task, popped ) )
+    {
+        //! Only the tasks of other groups are queued, the token goes back to the workers
+        sem_post( &m_queued );
+        return false;
+    }
+
+    run( index, task, group );
+    return true;
+}
+
+void
+ThreadPool::run( const int32_t index, Task& task, Group& group )
+{
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now( );
+    task( );
+    //! The captures go before the group is released, the waiter may free what they refer to
+    task = nullptr;
+    const auto busy_time
+        = std::chrono::duration_cast< std::chrono::microseconds >( Clock::now( ) - start );
+
+    if ( index >= 0 )
+    {
+        auto& worker = m_workers[ index ];
+        worker.tasks.fetch_add( 1, std::memory_order_relaxed );
+        worker.busy_time.fetch_add( busy_time.count( ), std::memory_order_relaxed );
+    }
+
+    group.m_pending.fetch_sub( 1, std::memory_order_release );
+    m_unfinished.fetch_sub( 1, std::memory_order_release );
+}
+
+bool
+ThreadPool::pop( const int32_t index, const Group* wanted, Task& task, Group*& group )
+{
+    const auto matches = [wanted]( const std::pair< Task, Group* >& queued ) {
+        return wanted == nullptr or queued.second == wanted;
+    };
+
+    if ( index >= 0 )
+    {
+        auto& own = m_workers[ index ];
+        std::lock_guard< std::mutex > lock( own.mutex );
+        const auto found = std::find_if( own.queue.rbegin( ), own.queue.rend( ), matches );
+        if ( found != own.queue.rend( ) )
+        {
+            std::tie( task, group ) = std::move( *found );
+            own.queue.erase( std::next( found ).base( ) );
+            return true;
+        }
+    }
+
+    const int32_t first = index >= 0 ? index + 1 : 0;
+    for ( int32_t offset = 0; offset < m_workers_count; ++offset )
+    {
+        const int32_t victim = ( first + offset ) % m_workers_count;
+        if ( victim == index )
+        {
+            continue;
+        }
+
+        auto& other = m_workers[ victim ];
+        std::lock_guard< std::mutex > lock( other.mutex );
+        const auto found = std::find_if( other.queue.begin( ), other.queue.end( ), matches );
+        if ( found != other.queue.end( ) )
+        {
+            std::tie( task, group ) = std::move( *found );
+            other.queue.erase( found );
+            if ( index >= 0 )
+            {
+                m_workers[ index ].steals.fetch_add( 1, std::memory_order_relaxed );
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+ThreadPool::pin( const int32_t index ) const
+{
+#if defined( __linux__ )
+    cpu_set_t available;
+    CPU_ZERO( &available );
+    if ( sched_getaffinity( 0, sizeof( available ), &available ) != 0 )
+    {
+        return;
+    }
+
+    const int32_t count = CPU_COUNT( &available );
+    for ( int32_t cpu = 0, seen = 0; cpu < CPU_SETSIZE; ++cpu )
+    {
+        if ( CPU_ISSET( cpu, &available ) and seen++ == index % count )
+        {
+            cpu_set_t cpus;
+            CPU_ZERO( &cpus );
+            CPU_SET( cpu, &cpus );
+            pthread_setaffinity_np( pthread_self( ), sizeof( cpus ), &cpus );
+            break;
+        }
+    }
+#endif
+}
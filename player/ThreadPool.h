@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <semaphore.h>
+
+//! Persistent workers created once per process. Each worker owns a deque: it runs its own
+//! tasks newest first and steals the oldest tasks of the others when it runs dry. The tables
+//! computations, the parallel searches and the tournaments all submit their tasks here instead
+//! of starting threads.
+class ThreadPool
+{
+public:
+    using Task = std::function< void( ) >;
+
+    //! Counts the unfinished tasks submitted with it
+    class Group
+    {
+    public:
+        Group( );
+
+        bool done( ) const;
+
+    private:
+        friend class ThreadPool;
+
+        std::atomic< int32_t > m_pending;
+    };
+
+    struct Utilization
+    {
+        uint64_t tasks;
+        uint64_t steals;
+        double busy_time;
+    };
+
+    //! Pinned workers are bound to one CPU each, round robin over the available ones
+    ThreadPool( const int32_t workers_count, const bool pinned );
+    //! Runs the remaining tasks before joining the workers
+    ~ThreadPool( );
+
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+
+    //! From a worker the task goes to its own deque, otherwise to the next worker in turn
+    void submit( const Task& task, Group& group );
+    //! Runs the pending tasks of the group while it is not done, so waiting from a task never
+    //! deadlocks and a short wait is never held up by a long task of another group
+    void wait( Group& group );
+
+    int32_t get_workers_count( ) const;
+    Utilization get_utilization( const int32_t worker ) const;
+    //! Logs the tasks, steals and busy share of every worker since the pool was created
+    void log_utilization( ) const;
+
+    //! Creates the pool of the process, later calls keep the first pool
+    static void init( const int32_t workers_count, const bool pinned );
+    //! The pool of the process, one worker per CPU unless init was called first
+    static ThreadPool& get( );
+
+private:
+    struct Worker;
+
+    void run_worker( const int32_t index );
+    //! Runs one queued task, the caller must have taken a token of m_queued first
+    void run_one( const int32_t index );
+    //! Runs one queued task of the group, returns false when none is queued
+    bool help( const int32_t index, Group& group );
+    void run( const int32_t index, Task& task, Group& group );
+    //! Own deque newest first, then the others oldest first; only the tasks of the wanted
+    //! group unless it is null
+    bool pop( const int32_t index, const Group* wanted, Task& task, Group*& group );
+    void pin( const int32_t index ) const;
+
+    std::unique_ptr< Worker[] > m_workers;
+    int32_t m_workers_count;
+    bool m_pinned;
+    //! One token per queued task, the idle workers sleep on it
+    sem_t m_queued;
+    std::atomic< uint32_t > m_next_worker;
+    //! Tasks submitted and not finished yet, of all the groups
+    std::atomic< int32_t > m_unfinished;
+    std::atomic< bool > m_stopping;
+    std::chrono::steady_clock::time_point m_start;
+};
@@ -1,11 +1,7 @@
 #include "Common.h"
 
-#include "Board.h"
 #include "Timer.h"
 
-int32_t Timer::s_total_time = 0;
-int32_t Timer::s_max_total_time = 30000000;
-
 using std::chrono::microseconds;
 using std::chrono::duration_cast;
 
@@ -34,7 +30,6 @@ Timer::stop( )
     m_end = SystemClock::now( );
     const auto dur = duration_cast< microseconds >( m_end - m_start );
     m_delta_time = (int32_t)dur.count( );
-    s_total_time += m_delta_time;
 }
 
 double
@@ -43,27 +38,6 @@ Timer::get_delta_time( )
     return 1e-6 * m_delta_time;
 }
 
-double
-Timer::get_max_time( const Board& board )
-{
-    const int32_t remaining_turns = 21 - ( board.get_turns( ) / 4 );
-    const int32_t max_turn_time = ( s_max_total_time - s_total_time ) / remaining_turns;
-
-    return 1e-6 * max_turn_time;
-}
-
-double
-Timer::get_total_time( )
-{
-    return 1e-6 * s_total_time;
-}
-
-double
-Timer::get_max_total_time( )
-{
-    return 1e-6 * s_max_total_time;
-}
-
 void
 Timer::set_alarm( const int32_t microseconds )
 {
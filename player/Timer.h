@@ -1,6 +1,5 @@
 #pragma once
 
-class Board;
 class Timer
 {
 public:
@@ -15,14 +14,7 @@ public:
     void clear_alarm( );
     bool is_time_over( ) const;
 
-    static double get_max_time( const Board& board );
-    static double get_total_time( );
-    static double get_max_total_time( );
-
 private:
-    static int32_t s_total_time;
-    static int32_t s_max_total_time;
-
     using SystemClock = std::chrono::system_clock;
     using TimePoint = SystemClock::time_point;
 
@@ -1,52 +1,170 @@
 #include "Common.h"
 
-#include "Board.h"
 #include "TranspositionTable.h"
 
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
 namespace
 {
-const int32_t buckets_count = 1000003;
+const size_t CACHE_LINE = 64;
+//! Buckets read by get_usage
+const size_t USAGE_SAMPLE = 1024;
+//! Depth given up per search of age when choosing the entry to replace: the entries of the
+//! previous turns go first, whatever their depth
+const int32_t AGE_WEIGHT = 8;
+
+static_assert( offsetof( Entry, value ) == sizeof( uint64_t ), "The data should follow the key" );
+
+uint64_t
+get_data( const Entry& entry )
+{
+    uint64_t data;
+    std::memcpy( &data, reinterpret_cast< const char* >( &entry ) + sizeof( entry.key ),
+                 sizeof( data ) );
+    return data;
+}
 }
 
-TranpositionTable::TranpositionTable( )
-    : m_buckets( buckets_count )
+TranspositionTable::TranspositionTable( const size_t megabytes )
+    : m_buckets( nullptr )
+    , m_mask( 0u )
+    , m_generation( 0 )
 {
+    static_assert( sizeof( Bucket ) == CACHE_LINE, "Bucket should fill a cache line" );
+
+    const size_t budget = std::max( megabytes << 20, sizeof( Bucket ) );
+    size_t buckets = 1;
+    while ( 2 * buckets * sizeof( Bucket ) <= budget )
+    {
+        buckets *= 2;
+    }
+
+    void* memory = nullptr;
+    if ( posix_memalign( &memory, CACHE_LINE, buckets * sizeof( Bucket ) ) != 0 )
+    {
+        throw std::bad_alloc( );
+    }
+
+    //! Zeroed slots hold entries of depth 0, no search stores such entries
+    std::memset( memory, 0, buckets * sizeof( Bucket ) );
+    m_buckets = static_cast< Bucket* >( memory );
+    m_mask = buckets - 1;
 }
 
-TranpositionTable::~TranpositionTable( )
+TranspositionTable::~TranspositionTable( )
 {
+    free( m_buckets );
 }
 
-const Entry*
-TranpositionTable::find( const Board& board )
+void
+TranspositionTable::new_generation( )
 {
-    const Entry* entry = nullptr;
+    m_generation = ( m_generation + 1 ) % GENERATIONS;
+}
 
-    const auto board_hash = board.get_hash( );
-    const auto board_lock = board.get_lock( );
-    const auto bucket_index = board_hash % buckets_count;
-    if ( m_buckets[ bucket_index ].lock == board_lock )
+bool
+TranspositionTable::find( const uint64_t key, Entry& entry ) const
+{
+    const Bucket& bucket = get_bucket( key );
+    for ( const auto& slot : bucket.slots )
     {
-        entry = &m_buckets[ bucket_index ];
+        entry = load( slot );
+        if ( entry.key == key and entry.depth > 0 )
+        {
+            return true;
+        }
     }
 
-    return entry;
+    return false;
 }
 
 void
-TranpositionTable::store( const Board& board,
-                          const int32_t depth,
-                          const Entry::Type type,
-                          const double value,
-                          const Move move )
-{
-    const auto board_hash = board.get_hash( );
-    const auto board_lock = board.get_lock( );
-    const auto bucket_index = board_hash % buckets_count;
-    Entry* entry = &m_buckets[ bucket_index ];
-    entry->lock = board_lock;
-    entry->depth = depth;
-    entry->type = type;
-    entry->value = value;
-    entry->move = move;
+TranspositionTable::store( const uint64_t key,
+                           const int32_t depth,
+                           const Entry::Type type,
+                           const double value,
+                           const Move move )
+{
+    Bucket& bucket = get_bucket( key );
+    Slot* replaced = nullptr;
+    Entry entry;
+    int32_t replaced_priority = 0;
+    for ( auto& slot : bucket.slots )
+    {
+        const Entry candidate = load( slot );
+        if ( candidate.key == key )
+        {
+            replaced = &slot;
+            entry = candidate;
+            break;
+        }
+
+        const int32_t age = ( m_generation - candidate.generation ) & ( GENERATIONS - 1 );
+        const int32_t priority = candidate.depth - AGE_WEIGHT * age;
+        if ( replaced == nullptr or priority < replaced_priority )
+        {
+            replaced = &slot;
+            replaced_priority = priority;
+        }
+    }
+
+    //! A bound without a move keeps the move found before for the same position
+    if ( move != INVALID_MOVE or entry.key != key )
+    {
+        entry.move = move;
+    }
+
+    entry.key = key;
+    entry.value = static_cast< float >( value );
+    entry.depth = static_cast< int8_t >( depth );
+    entry.type = type;
+    entry.generation = m_generation;
+
+    const uint64_t data = get_data( entry );
+    replaced->checked_key.store( key ^ data, std::memory_order_relaxed );
+    replaced->data.store( data, std::memory_order_relaxed );
+}
+
+size_t
+TranspositionTable::get_size( ) const
+{
+    return ( m_mask + 1 ) * BUCKET_ENTRIES;
+}
+
+double
+TranspositionTable::get_usage( ) const
+{
+    const size_t buckets = std::min< size_t >( USAGE_SAMPLE, m_mask + 1 );
+    size_t used = 0;
+    for ( size_t index = 0; index < buckets; ++index )
+    {
+        for ( const auto& slot : m_buckets[ index ].slots )
+        {
+            const Entry entry = load( slot );
+            used += entry.depth > 0 and entry.generation == m_generation;
+        }
+    }
+
+    return static_cast< double >( used ) / ( buckets * BUCKET_ENTRIES );
+}
+
+Entry
+TranspositionTable::load( const Slot& slot )
+{
+    const uint64_t data = slot.data.load( std::memory_order_relaxed );
+    const uint64_t checked_key = slot.checked_key.load( std::memory_order_relaxed );
+
+    Entry entry;
+    entry.key = checked_key ^ data;
+    std::memcpy( reinterpret_cast< char* >( &entry ) + sizeof( entry.key ), &data,
+                 sizeof( data ) );
+    return entry;
+}
+
+TranspositionTable::Bucket&
+TranspositionTable::get_bucket( const uint64_t key ) const
+{
+    return m_buckets[ key & m_mask ];
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+
+//! 16 bytes: the key and 8 bytes of data, four of them fill a bucket of one cache line
 struct Entry
 {
     enum Type : uint8_t
@@ -10,35 +13,80 @@ struct Entry
     };
 
     Entry( )
-        : lock( 0u )
+        : key( 0u )
+        , value( 0.0f )
+        , move( INVALID_MOVE )
         , depth( 0 )
         , type( EXACT )
-        , value( 0.0 )
-        , move( INVALID_MOVE )
+        , generation( 0 )
     {
     }
 
-    uint32_t lock;
-    int32_t depth;
-    Type type;
-    double value;
+    uint64_t key;
+    float value;
     Move move;
+    int8_t depth;
+    uint8_t type : 2;
+    //! Search of the table that wrote the entry, modulo GENERATIONS
+    uint8_t generation : 6;
 };
 
-class Board;
-class TranpositionTable
+static_assert( sizeof( Entry ) == 16, "Entry should take 16 bytes" );
+
+//! Kept by the search context across the turns of a game: the entries of the previous turns
+//! stay valid and are only aged. The lookups use the full 64 bits key, the low bits of the key
+//! select the bucket.
+//!
+//! The threads of a search share the table without locks: a slot holds the data and the key
+//! xored with the data, so a slot torn by concurrent stores fails the key check and is a miss.
+class TranspositionTable
 {
 public:
-    TranpositionTable( );
-    ~TranpositionTable( );
+    static const int32_t BUCKET_ENTRIES = 4;
+    static const int32_t GENERATIONS = 64;
 
-    const Entry* find( const Board& board );
-    void store( const Board& board,
+    //! The number of buckets is the largest power of two fitting the memory budget
+    explicit TranspositionTable( const size_t megabytes );
+    ~TranspositionTable( );
+
+    TranspositionTable( const TranspositionTable& ) = delete;
+    TranspositionTable& operator=( const TranspositionTable& ) = delete;
+
+    //! Starts a search, the entries written by the previous ones become older
+    void new_generation( );
+
+    //! Copies the entry of the key, returns false when the table has none
+    bool find( const uint64_t key, Entry& entry ) const;
+    //! Overwrites the entry of the same key, otherwise the oldest and shallowest of the bucket
+    void store( const uint64_t key,
                 const int32_t depth,
                 const Entry::Type type,
                 const double value,
                 const Move move );
 
+    size_t get_size( ) const;
+    //! Share of the entries written by the current generation, sampled over the first buckets
+    double get_usage( ) const;
+
 private:
-    std::vector< Entry > m_buckets;
+    struct Slot
+    {
+        std::atomic< uint64_t > checked_key;
+        std::atomic< uint64_t > data;
+    };
+
+    struct Bucket
+    {
+        Slot slots[ BUCKET_ENTRIES ];
+    };
+
+    static Entry load( const Slot& slot );
+
+    Bucket& get_bucket( const uint64_t key ) const;
+
+    //! Cache line aligned
+    Bucket* m_buckets;
+    uint64_t m_mask;
+    //! Only changed between the searches
+    uint8_t m_generation;
 };
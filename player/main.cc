@@ -2,16 +2,22 @@
 
 #include "Board.h"
 #include "Conversion.h"
+#include "Coordinator.h"
 #include "ExpectMinMaxStrategy.h"
 #include "MCTSStrategy.h"
-#include "Node.h"
-#include "RandomNumberGenerator.h"
 #include "RunStrategy.h"
+#include "SearchContext.h"
+#include "Server.h"
+#include "ThreadPool.h"
+#include "Timer.h"
 
 using AdoptedStrategy = MCTSStrategy;
 
 namespace
 {
+//! Threads of every search, the MCTS trees or the ExpectMinMax searchers, set with --threads
+int32_t search_threads = 1;
+
 Board::Player
 get_player( const std::string& color )
 {
@@ -36,10 +42,12 @@ get_player( const std::string& color )
 int
 usage( )
 {
-    std::cout << "Player or\n";
+    std::cout << "Player [--shared-tables] or\n";
     std::cout << "Player --test-run-strategy or\n";
     std::cout << "Player --test-random-move or\n";
-    std::cout << "Player --analyze\n";
+    std::cout << "Player --analyze [--lazy] [--processes <count>] or\n";
+    std::cout << "Player --server <socket path> [--workers <count>]\n";
+    std::cout << "all of them also take [--threads <count>] [--pin]\n";
 
     return 1;
 }
@@ -56,7 +64,8 @@ test_run_strategy( )
     Board board;
     board.enable_solo_mode( Board::YELLOW );
 
-    const auto best_action = RunStrategy( ).get_best_action( board );
+    SearchContext search;
+    const auto best_action = RunStrategy( search ).get_best_run( board );
     for ( const auto move : best_action )
     {
         board.do_move( move );
@@ -75,13 +84,15 @@ test_random_move( )
     Board::init_data( layout );
     Board::pre_compute( );
     Board board;
+    SearchContext search;
+    search.random.randomize( );
     std::ostringstream stream;
     int32_t moves_count = 0;
     auto previous_player = Board::RED;
     std::cerr << "random game moves\n";
     while ( not board.end_game( ) )
     {
-        const auto random_move = board.get_random_move( );
+        const auto random_move = board.get_random_move( search.random );
         const auto player = board.get_player( );
         if ( player == previous_player )
         {
@@ -105,32 +116,99 @@ test_random_move( )
     return 0;
 }
 
+//! With processes the position is searched by as many worker processes, see Coordinator
 int
-analyze( )
+analyze( const bool lazy, const int32_t processes )
 {
     std::string walls;
     std::cin >> walls;
 
     Board::init_data( walls );
-    Board::pre_compute( );
-    Node::init_data( );
+    //! The worker processes map the tables shared here
+    const bool lazy_tables = lazy and processes == 0;
+    if ( lazy_tables )
+    {
+        Board::init_lazy_tables( );
+    }
+    else if ( processes == 0 or not Board::share_tables( ) )
+    {
+        Board::pre_compute( );
+    }
+
+    SearchContext search;
+    search.random.randomize( );
+    search.threads = search_threads;
+    if ( lazy_tables and search_threads > 1 )
+    {
+        //! The reads of lazy tables write the context, a single thread may search it
+        std::cerr << "Lazy tables, searching with one thread\n";
+        search.threads = 1;
+    }
 
     Board board;
+    std::vector< Action > actions;
 
     std::string s;
     for ( std::cin >> s; s != "End"; std::cin >> s )
     {
+        if ( not Conversion::is_valid_action( s ) )
+        {
+            std::cerr << "Invalid action " << s << "\n";
+            return 1;
+        }
+
         const auto action = Conversion::string_to_action( s );
         board.do_action( action );
+        actions.push_back( action );
     }
 
     board.display( );
-    const auto best_action = AdoptedStrategy( board.get_player( ) ).get_best_action( board );
+    Action best_action;
+    if ( processes > 0 )
+    {
+        best_action = Coordinator( walls, processes ).get_best_action( actions, search.random );
+    }
+    else
+    {
+        AdoptedStrategy strategy( search, board.get_player( ) );
+        best_action = strategy.get_best_action( board );
+    }
+
     std::cerr << Conversion::action_to_string( best_action ) << std::endl;
 
     return 0;
 }
 
+//! One game of MCTS against ExpectMinMax, returns the MCTS score bounded to [-10, 10]
+double
+play_match( const int32_t game )
+{
+    SearchContext search;
+    search.random.randomize( );
+    search.threads = search_threads;
+
+    const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
+    const Board::Player player = players[ game % 4 ];
+    Board board;
+    while ( not board.end_game( ) )
+    {
+        Action action;
+        const auto p = board.get_player( );
+        if ( p == player )
+        {
+            action = MCTSStrategy( search, p ).get_best_action( board );
+        }
+        else
+        {
+            action = ExpectMinMaxStrategy( search, p ).get_best_action( board );
+        }
+
+        board.do_action( action );
+    }
+
+    return std::min( std::max( board.get_score( player ), -10.0 ), +10.0 );
+}
+
 int
 compare_strategies( )
 {
@@ -139,69 +217,137 @@ compare_strategies( )
 
     Board::init_data( walls );
     Board::pre_compute( );
-    Node::init_data( );
 
-    std::vector< double > scores;
-    const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
-    for ( int i = 0; i < 100; ++i )
+    //! The games are independent, each one is a pool task with its own search context
+    const int32_t games = 100;
+    std::vector< double > scores( games );
+    ThreadPool::Group group;
+    for ( int32_t i = 0; i < games; ++i )
     {
-        Board::Player player = players[ i % 4 ];
-        Board board;
-        while ( not board.end_game( ) )
-        {
-            Action action;
-            const auto p = board.get_player( );
-            if ( p == player )
-            {
-                action = MCTSStrategy( p ).get_best_action( board );
-            }
-            else
-            {
-                action = ExpectMinMaxStrategy( p ).get_best_action( board );
-            }
+        ThreadPool::get( ).submit( [i, &scores]( ) { scores[ i ] = play_match( i ); }, group );
+    }
 
-            board.do_action( action );
-        }
-        double score = board.get_score( player );
-        if ( score < -10.0 )
-        {
-            score = -10.0;
-        }
-        if ( score > +10.0 )
-        {
-            score = +10.0;
-        }
+    ThreadPool::get( ).wait( group );
+    for ( const auto score : scores )
+    {
         std::cout << "score=" << score << std::endl;
-        scores.push_back( score );
     }
 
     std::cout << "average-score="
               << 0.01 * std::accumulate( scores.cbegin( ), scores.cend( ), 0.0,
                                          std::plus< double >( ) )
               << std::endl;
+    ThreadPool::get( ).log_utilization( );
 
     return 0;
 }
 
 int
-main_loop( )
+play_solo( SearchContext& search, Board& board, const Board::Player me, std::ostream& out )
 {
-    std::string walls;
-    std::cin >> walls;
-    std::cerr << "walls=" << walls << std::endl;
+    board.enable_solo_mode( me );
 
-    Board::init_data( walls );
-    Board::pre_compute( );
-    Node::init_data( );
+    RunAction action;
+    {
+        Server::SearchSlot slot;
+        action = RunStrategy( search ).get_best_run( board );
+    }
 
-    Board board;
+    for ( const auto move : action )
+    {
+        out << Conversion::move_to_string( move ) << std::endl;
+    }
+
+    return 0;
+}
+
+//! Only the wait is charged to the search, the opponents' turns before ours are not
+Board
+replay_when_ready( SearchContext& search,
+                   const std::vector< Action >& actions,
+                   const Board::ContextId context )
+{
+    Timer timer;
+    Board::wait_for_tables( 0xfu, context );
+    timer.stop( );
+    search.add_time( timer );
+    std::cerr << "Waited for tables " << timer.get_delta_time( ) << " sec\n";
+
+    Board board{context};
+    for ( const auto& action : actions )
+    {
+        board.do_action( action );
+    }
+
+    return board;
+}
+
+//! The game once the context of the walls is taken, the init timer runs until the tables are
+//! started
+int
+play_context( std::istream& in,
+              std::ostream& out,
+              const Board::ContextId context,
+              const bool shared_tables,
+              Timer& init_timer )
+{
+    SearchContext search;
+    search.random.randomize( );
+    search.threads = search_threads;
+
+    if ( not shared_tables or not Board::share_tables( context ) )
+    {
+        Board::start_pre_compute( context );
+    }
+
+    init_timer.stop( );
+    search.add_time( init_timer );
 
     // read color
     std::string color;
-    std::cin >> color;
+    in >> color;
     std::cerr << "color=" << color << std::endl;
 
     const auto me = get_player( color );
+    Board::prioritize_tables( 1u << me | 1u << Board::get_teammate( me ), context );
+
+    //! Until our first turn the actions are only parsed, they are replayed once the tables
+    //! are ready; each action ends the turn of one player
+    std::vector< Action > pending_actions;
+    for ( auto player = Board::YELLOW; player != me;
+          player = static_cast< Board::Player >( ( player + 1 ) & 3 ) )
+    {
+        std::string s;
+        if ( not( in >> s ) or s == "Quit" )
+        {
+            return 0;
+        }
+        else if ( s == "Move" )
+        {
+            //! Alone from the start only our table is needed
+            if ( pending_actions.empty( ) )
+            {
+                Board::wait_for_tables( 1u << me, context );
+                Board board{me, Board::get_start( me ), context};
+                return play_solo( search, board, me, out );
+            }
+
+            auto board = replay_when_ready( search, pending_actions, context );
+            return play_solo( search, board, me, out );
+        }
+        else if ( not Conversion::is_valid_action( s ) )
+        {
+            std::cerr << "Invalid action " << s << "\n";
+            return 1;
+        }
+        else
+        {
+            std::cerr << "\t" << s << std::endl;
+            pending_actions.push_back( Conversion::string_to_action( s ) );
+        }
+    }
+
+    auto board = replay_when_ready( search, pending_actions, context );
 
     while ( true )
     {
@@ -209,21 +355,18 @@ main_loop( )
         while ( board.get_player( ) != me )
         {
             std::string s;
-            std::cin >> s;
-            if ( s == "Quit" )
+            if ( not( in >> s ) or s == "Quit" )
             {
                 return 0;
             }
             else if ( s == "Move" )
             {
-                board.enable_solo_mode( me );
-                const auto action = RunStrategy( ).get_best_action( board );
-                for ( const auto move : action )
-                {
-                    std::cout << Conversion::move_to_string( move ) << std::endl;
-                }
-
-                return 0;
+                return play_solo( search, board, me, out );
+            }
+            else if ( not Conversion::is_valid_action( s ) )
+            {
+                std::cerr << "Invalid action " << s << "\n";
+                return 1;
             }
             else
             {
@@ -233,17 +376,100 @@ main_loop( )
             }
         }
 
-        const auto best_action = AdoptedStrategy{me}.get_best_action( board );
+        Action best_action;
+        {
+            Server::SearchSlot slot;
+            best_action = AdoptedStrategy( search, me ).get_best_action( board );
+        }
+
         board.do_action( best_action );
-        std::cout << Conversion::action_to_string( best_action ) << std::endl;
+        out << Conversion::action_to_string( best_action ) << std::endl;
+    }
+}
+
+//! Plays one game over the streams, the boards use the context of the walls read first so that
+//! the games of a server may run on different layouts. All the search state of the game lives
+//! in its own context, the games of a server share nothing but the tables
+int
+play_game( std::istream& in, std::ostream& out, const bool shared_tables )
+{
+    std::string walls;
+    if ( not( in >> walls ) )
+    {
+        return 1;
+    }
+
+    std::cerr << "walls=" << walls << std::endl;
+    if ( not Board::are_valid_walls( walls ) )
+    {
+        std::cerr << "Invalid walls\n";
+        return 1;
+    }
+
+    //! Our own start-up work is charged to the search, reading the walls is not
+    Timer init_timer;
+    const auto context = Board::init_context( walls );
+    if ( context == Board::NO_CONTEXT )
+    {
+        return 1;
     }
+
+    const int result = play_context( in, out, context, shared_tables, init_timer );
+    Board::release_context( context );
+
+    return result;
+}
+
+int
+main_loop( const bool shared_tables )
+{
+    const int result = play_game( std::cin, std::cout, shared_tables );
+    ThreadPool::get( ).log_utilization( );
+
+    return result;
+}
+
+int
+serve( const std::string& socket_path, const int32_t workers_count )
+{
+    Server server( socket_path, workers_count, []( std::istream& in, std::ostream& out ) {
+        return play_game( in, out, false );
+    } );
+
+    return server.run( );
+}
+
+//! Takes the thread pool options out of the arguments and creates the pool
+void
+init_thread_pool( int& argc, char** argv )
+{
+    bool pinned = false;
+    int32_t count = 1;
+    for ( int32_t i = 1; i < argc; ++i )
+    {
+        if ( std::string( "--pin" ) == argv[ i ] )
+        {
+            pinned = true;
+        }
+        else if ( std::string( "--threads" ) == argv[ i ] and i + 1 < argc )
+        {
+            search_threads = std::max( std::atoi( argv[ ++i ] ), 1 );
+        }
+        else
+        {
+            argv[ count++ ] = argv[ i ];
+        }
+    }
+
+    argc = count;
+    ThreadPool::init( std::thread::hardware_concurrency( ), pinned );
 }
 }
 
 int
 main( int argc, char** argv )
 {
-    RandomNumberGenerator::randomize( );
+    init_thread_pool( argc, argv );
 
     if ( argc > 1 )
     {
@@ -253,7 +479,25 @@ main( int argc, char** argv )
         }
         else if ( std::string( "--analyze" ) == argv[ 1 ] )
         {
-            return analyze( );
+            bool lazy = false;
+            int32_t processes = 0;
+            for ( int32_t i = 2; i < argc; ++i )
+            {
+                if ( std::string( "--lazy" ) == argv[ i ] )
+                {
+                    lazy = true;
+                }
+                else if ( std::string( "--processes" ) == argv[ i ] and i + 1 < argc )
+                {
+                    processes = std::max( std::atoi( argv[ ++i ] ), 1 );
+                }
+            }
+
+            return analyze( lazy, processes );
+        }
+        else if ( std::string( "--analyze-worker" ) == argv[ 1 ] and argc > 2 )
+        {
+            return Coordinator::serve_worker( std::atoi( argv[ 2 ] ) );
         }
         else if ( std::string( "--test-random-move" ) == argv[ 1 ] )
         {
@@ -263,6 +507,18 @@ main( int argc, char** argv )
         {
             return compare_strategies( );
         }
+        else if ( std::string( "--shared-tables" ) == argv[ 1 ] )
+        {
+            return main_loop( true );
+        }
+        else if ( std::string( "--server" ) == argv[ 1 ] and argc > 2 )
+        {
+            const bool has_workers = argc > 4 and std::string( "--workers" ) == argv[ 3 ];
+            const int32_t workers_count = has_workers
+                                              ? std::atoi( argv[ 4 ] )
+                                              : std::thread::hardware_concurrency( );
+            return serve( argv[ 2 ], std::max( workers_count, 1 ) );
+        }
         else
         {
             return usage( );
@@ -270,6 +526,6 @@ main( int argc, char** argv )
     }
     else
     {
-        return main_loop( );
+        return main_loop( false );
     }
 }
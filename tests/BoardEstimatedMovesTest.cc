@@ -0,0 +1,185 @@
+#include "BoardTestBase.h"
+
+#include "../player/CombinationIndex.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
+
+//! All the 4-stones bitmasks
+const int32_t bitmasks_count = 635376;
+
+const int32_t random_layouts = 2;
+
+//! Wall counts right of and below the fields, read from the layout as init_context does
+struct Walls
+{
+    explicit Walls( const std::string& walls )
+    {
+        int32_t index = 0;
+        for ( int32_t i = 0; i < N; ++i )
+        {
+            for ( int32_t j = 0; j < N - 1; ++j )
+            {
+                right[ N * i + j ] = walls[ index++ ] - '0';
+            }
+
+            if ( i < N - 1 )
+            {
+                for ( int32_t j = 0; j < N; ++j )
+                {
+                    below[ N * i + j ] = walls[ index++ ] - '0';
+                }
+            }
+        }
+    }
+
+    int32_t right[ NXN ] = {};
+    int32_t below[ NXN ] = {};
+};
+
+//! Distances of all the bitmasks to the target of the player, searched with a plain queue:
+//! a bitmask is queued again each time its distance gets shorter
+std::vector< int32_t >
+search_estimated_moves( const std::string& layout_walls, const Board::Player player )
+{
+    const Walls walls( layout_walls );
+    std::vector< int32_t > distances( bitmasks_count, -1 );
+    std::queue< uint64_t > queue;
+
+    const uint64_t target = Board::get_start( static_cast< Board::Player >( 3 - player ) );
+    distances[ CombinationIndex::get( target ) ] = 0;
+    queue.push( target );
+
+    while ( not queue.empty( ) )
+    {
+        const uint64_t bitmask = queue.front( );
+        queue.pop( );
+        const int32_t distance = distances[ CombinationIndex::get( bitmask ) ];
+
+        const auto visit = [&]( const int32_t from, const int32_t to, const int32_t count ) {
+            if ( bitmask & 1ull << to )
+            {
+                return;
+            }
+
+            const uint64_t neighbor = bitmask ^ 1ull << from ^ 1ull << to;
+            int32_t& neighbor_distance = distances[ CombinationIndex::get( neighbor ) ];
+            if ( neighbor_distance == -1 or neighbor_distance > distance + count )
+            {
+                neighbor_distance = distance + count;
+                queue.push( neighbor );
+            }
+        };
+
+        //! Steps cost one move per crossed wall more, jumps over an own stone cost one move
+        //! and cross no wall
+        for ( int32_t field = 0; field < NXN; ++field )
+        {
+            if ( ( bitmask & 1ull << field ) == 0ull )
+            {
+                continue;
+            }
+
+            const int32_t column = field % N;
+            if ( column < N - 1 )
+            {
+                visit( field, field + 1, 1 + walls.right[ field ] );
+            }
+            if ( column > 0 )
+            {
+                visit( field, field - 1, 1 + walls.right[ field - 1 ] );
+            }
+            if ( field + N < NXN )
+            {
+                visit( field, field + N, 1 + walls.below[ field ] );
+            }
+            if ( field >= N )
+            {
+                visit( field, field - N, 1 + walls.below[ field - N ] );
+            }
+
+            if ( column < N - 2 and bitmask & 1ull << ( field + 1 )
+                 and walls.right[ field ] + walls.right[ field + 1 ] == 0 )
+            {
+                visit( field, field + 2, 1 );
+            }
+            if ( column > 1 and bitmask & 1ull << ( field - 1 )
+                 and walls.right[ field - 2 ] + walls.right[ field - 1 ] == 0 )
+            {
+                visit( field, field - 2, 1 );
+            }
+            if ( field + 2 * N < NXN and bitmask & 1ull << ( field + N )
+                 and walls.below[ field ] + walls.below[ field + N ] == 0 )
+            {
+                visit( field, field + 2 * N, 1 );
+            }
+            if ( field >= 2 * N and bitmask & 1ull << ( field - N )
+                 and walls.below[ field - 2 * N ] + walls.below[ field - N ] == 0 )
+            {
+                visit( field, field - 2 * N, 1 );
+            }
+        }
+    }
+
+    return distances;
+}
+
+//! Every Store entry of the context, read by the boards of a single player
+void
+check_tables( const std::string& walls, const Board::ContextId context )
+{
+    for ( const auto player : players )
+    {
+        const auto distances = search_estimated_moves( walls, player );
+        for ( int32_t index = 0; index < bitmasks_count; ++index )
+        {
+            const Board board( player, CombinationIndex::get_bitmask( index ), context );
+            ASSERT_LE( 0, distances[ index ] );
+            ASSERT_EQ( distances[ index ], board.get_estimated_moves( player ) )
+                << "player " << static_cast< int32_t >( player ) << " index " << index;
+        }
+    }
+}
+}
+
+class BoardEstimatedMovesTest : public BoardTestBase
+{
+public:
+    BoardEstimatedMovesTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardEstimatedMovesTest, tables_match_queue_search )
+{
+    Board::pre_compute( );
+    check_tables( layout, Board::get_default_context( ) );
+}
+
+TEST_F( BoardEstimatedMovesTest, random_layout_tables_match_queue_search )
+{
+    std::mt19937 engine( 38u );
+    //! About as many walls as the game layouts, the distances stay within the Store entries
+    std::discrete_distribution< int32_t > wall_count{14, 4, 2};
+    for ( int32_t i = 0; i < random_layouts; ++i )
+    {
+        std::string walls( layout.size( ), '0' );
+        for ( auto& wall : walls )
+        {
+            wall = static_cast< char >( '0' + wall_count( engine ) );
+        }
+
+        const auto context = Board::init_context( walls );
+        ASSERT_NE( Board::NO_CONTEXT, context );
+        Board::pre_compute( context );
+        check_tables( walls, context );
+        Board::release_context( context );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "walls " << walls;
+    }
+}
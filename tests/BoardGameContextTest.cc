@@ -0,0 +1,119 @@
+#include "BoardTestBase.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const std::string open_layout( 112, '0' );
+//! Walls right of and below all the fields of the first row
+const std::string walled_layout = std::string( 15, '1' ) + std::string( 97, '0' );
+}
+
+class BoardGameContextTest : public BoardTestBase
+{
+public:
+    BoardGameContextTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardGameContextTest, context_is_reused_for_the_same_walls )
+{
+    const auto open_context = Board::init_data( open_layout );
+    const auto walled_context = Board::init_data( walled_layout );
+
+    ASSERT_NE( open_context, walled_context );
+    ASSERT_EQ( open_context, Board::init_data( open_layout ) );
+    ASSERT_EQ( open_context, Board::get_default_context( ) );
+}
+
+TEST_F( BoardGameContextTest, walls_follow_the_default_context )
+{
+    Board::init_data( walled_layout );
+    ASSERT_TRUE( has_vertical_wall( 0 ) );
+
+    Board::init_data( open_layout );
+    ASSERT_FALSE( has_vertical_wall( 0 ) );
+}
+
+TEST_F( BoardGameContextTest, boards_keep_the_tables_of_their_context )
+{
+    const auto open_context = Board::init_data( open_layout );
+    Board::pre_compute( open_context );
+    const Board open_board{open_context};
+
+    const auto walled_context = Board::init_data( walled_layout );
+    Board::pre_compute( walled_context );
+    const Board walled_board{walled_context};
+
+    //! The walls of the first row slow down the players starting there
+    ASSERT_LT( open_board.get_estimated_moves( Board::BLACK ),
+               walled_board.get_estimated_moves( Board::BLACK ) );
+    ASSERT_EQ( open_board.get_estimated_moves( Board::BLACK ),
+               Board( open_context ).get_estimated_moves( Board::BLACK ) );
+}
+
+namespace
+{
+//! A single wall, distinct for each index and from the layouts above
+std::string
+get_single_wall_layout( const int32_t index )
+{
+    std::string walls( 112, '0' );
+    walls[ index ] = '1';
+
+    return walls;
+}
+}
+
+TEST_F( BoardGameContextTest, released_contexts_are_reused )
+{
+    //! More layouts than a process keeps at once
+    for ( int32_t index = 0; index < 40; ++index )
+    {
+        const auto context = Board::init_context( get_single_wall_layout( index ) );
+        ASSERT_NE( Board::NO_CONTEXT, context );
+        Board::release_context( context );
+    }
+}
+
+TEST_F( BoardGameContextTest, contexts_run_out_without_release )
+{
+    std::vector< Board::ContextId > taken;
+    for ( int32_t index = 0; index < 40; ++index )
+    {
+        const auto context = Board::init_context( get_single_wall_layout( index ) );
+        if ( context == Board::NO_CONTEXT )
+        {
+            break;
+        }
+
+        taken.push_back( context );
+    }
+
+    const bool ran_out = taken.size( ) < 40u;
+    for ( const auto context : taken )
+    {
+        Board::release_context( context );
+    }
+
+    ASSERT_TRUE( ran_out );
+    const auto context = Board::init_context( get_single_wall_layout( 0 ) );
+    ASSERT_NE( Board::NO_CONTEXT, context );
+    Board::release_context( context );
+}
+
+TEST_F( BoardGameContextTest, only_well_formed_walls_are_valid )
+{
+    ASSERT_TRUE( Board::are_valid_walls( layout ) );
+    ASSERT_TRUE( Board::are_valid_walls( walled_layout ) );
+
+    ASSERT_FALSE( Board::are_valid_walls( "" ) );
+    ASSERT_FALSE( Board::are_valid_walls( layout.substr( 1 ) ) );
+    ASSERT_FALSE( Board::are_valid_walls( layout + "0" ) );
+    ASSERT_FALSE( Board::are_valid_walls( std::string( 111, '0' ) + "3" ) );
+    ASSERT_FALSE( Board::are_valid_walls( std::string( 111, '0' ) + "x" ) );
+}
@@ -0,0 +1,177 @@
+#include "BoardTestBase.h"
+
+#include <functional>
+
+#include "../player/RandomNumberGenerator.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
+
+const int32_t games = 20;
+
+uint64_t
+get_target( const Board::Player player )
+{
+    return Board::get_start( static_cast< Board::Player >( 3 - player ) );
+}
+
+//! Score of the first team computed from the estimates the board keeps
+double
+get_team_score( const Board& board )
+{
+    return board.get_estimated_moves( Board::BLACK ) + board.get_estimated_moves( Board::RED )
+           - board.get_estimated_moves( Board::YELLOW )
+           - board.get_estimated_moves( Board::WHITE );
+}
+
+//! Compares the state kept by the moves with the one recomputed from the stones of the player
+void
+check_player( const Board& board, const Board::Player player )
+{
+    Board reference = board;
+    reference.update_estimated_moves( player );
+
+    ASSERT_EQ( reference.get_estimated_moves( player ), board.get_estimated_moves( player ) );
+    ASSERT_EQ( Board::compute_index( board.get_bitmask( player ) ), board.get_index( player ) );
+    ASSERT_EQ( board.get_bitmask( player ) == get_target( player ), board.is_done( player ) );
+}
+
+void
+check_team_board( const Board& board )
+{
+    for ( const auto player : players )
+    {
+        check_player( board, player );
+    }
+
+    ASSERT_EQ( get_team_score( board ), board.get_score( Board::YELLOW ) );
+    ASSERT_EQ( -get_team_score( board ), board.get_score( Board::BLACK ) );
+}
+
+//! The other players are left out in solo mode and their estimates are not kept up to date
+void
+check_solo_board( const Board& board, const Board::Player solo_player )
+{
+    check_player( board, solo_player );
+    for ( const auto player : players )
+    {
+        if ( player != solo_player )
+        {
+            ASSERT_FALSE( board.is_done( player ) );
+        }
+    }
+
+    ASSERT_EQ( get_team_score( board ), board.get_score( Board::YELLOW ) );
+}
+
+//! Alternates the specialized and the generic move paths, returns the number of moves played
+int32_t
+play( Board& board,
+      RandomNumberGenerator& random,
+      const int32_t max_moves,
+      const std::function< void( const Board& ) >& check )
+{
+    int32_t moves = 0;
+    while ( moves < max_moves and not board.end_game( ) )
+    {
+        if ( moves % 2 == 0 )
+        {
+            if ( board.do_random_move( random ) == INVALID_MOVE )
+            {
+                break;
+            }
+        }
+        else
+        {
+            const auto move = board.get_random_move( random );
+            if ( move == INVALID_MOVE )
+            {
+                break;
+            }
+
+            board.do_move( move );
+        }
+
+        ++moves;
+        check( board );
+        if ( ::testing::Test::HasFatalFailure( ) )
+        {
+            break;
+        }
+    }
+
+    return moves;
+}
+}
+
+class BoardIncrementalStateTest : public BoardTestBase
+{
+public:
+    BoardIncrementalStateTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardIncrementalStateTest, team_games_keep_state )
+{
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    random.seed( 31u );
+    for ( int32_t game = 0; game < games; ++game )
+    {
+        Board board;
+        check_team_board( board );
+        play( board, random, OO, check_team_board );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "game " << game;
+    }
+}
+
+TEST_F( BoardIncrementalStateTest, teammates_of_done_players_keep_state )
+{
+    Board::pre_compute( );
+
+    //! Yellow and red start on their targets, their turns move the stones of white and black
+    const uint64_t bitmasks[ 4 ] = {get_target( Board::YELLOW ), Board::get_start( Board::BLACK ),
+                                    Board::get_start( Board::WHITE ), get_target( Board::RED )};
+
+    RandomNumberGenerator random;
+    random.seed( 31u );
+    for ( int32_t game = 0; game < games; ++game )
+    {
+        Board board{Board::YELLOW, bitmasks};
+        ASSERT_TRUE( board.is_done( Board::YELLOW ) );
+        ASSERT_TRUE( board.is_done( Board::RED ) );
+        check_team_board( board );
+        play( board, random, OO, check_team_board );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "game " << game;
+    }
+}
+
+TEST_F( BoardIncrementalStateTest, solo_games_keep_state )
+{
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    random.seed( 31u );
+    for ( int32_t game = 0; game < games; ++game )
+    {
+        //! Solo mode is enabled at the start of the game or after a few team moves
+        Board board;
+        const int32_t team_moves = game % 4 * 8;
+        ASSERT_EQ( team_moves, play( board, random, team_moves, check_team_board ) );
+
+        const auto solo_player = board.get_player( );
+        board.enable_solo_mode( solo_player );
+        const auto check = [solo_player]( const Board& b ) { check_solo_board( b, solo_player ); };
+        check( board );
+        play( board, random, MAX_RUN_MOVES, check );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "game " << game;
+    }
+}
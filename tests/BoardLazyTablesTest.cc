@@ -0,0 +1,59 @@
+#include "BoardTestBase.h"
+
+namespace
+{
+//! One wall away from the layout of the other tests, so that none of them completes the tables
+//! of this one first
+const std::string layout(
+    "01100000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const std::vector< uint64_t > bitmasks{1ull << 48 | 1ull << 49 | 1ull << 56 | 1ull << 57,
+                                       1ull << 0 | 1ull << 1 | 1ull << 8 | 1ull << 9,
+                                       1ull << 54 | 1ull << 55 | 1ull << 62 | 1ull << 63,
+                                       1ull << 6 | 1ull << 7 | 1ull << 14 | 1ull << 22,
+                                       1ull << 3 | 1ull << 20 | 1ull << 21 | 1ull << 40,
+                                       1ull << 0 | 1ull << 27 | 1ull << 36 | 1ull << 63};
+
+const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
+}
+
+class BoardLazyTablesTest : public BoardTestBase
+{
+public:
+    BoardLazyTablesTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardLazyTablesTest, lazy_estimates_match_pre_computed )
+{
+    Board::init_lazy_tables( );
+    ASSERT_FALSE( Board::has_complete_tables( ) );
+
+    std::vector< double > lazy_estimates;
+    for ( const auto bitmask : bitmasks )
+    {
+        for ( const auto player : players )
+        {
+            const Board board{player, bitmask};
+            lazy_estimates.push_back( board.get_estimated_moves( player ) );
+        }
+    }
+
+    //! The reads settled the entries on the fly, nothing computed the tables in full
+    ASSERT_FALSE( Board::has_complete_tables( ) );
+    Board::pre_compute( );
+    ASSERT_TRUE( Board::has_complete_tables( ) );
+
+    size_t i = 0;
+    for ( const auto bitmask : bitmasks )
+    {
+        for ( const auto player : players )
+        {
+            const Board board{player, bitmask};
+            ASSERT_EQ( board.get_estimated_moves( player ), lazy_estimates[ i++ ] );
+        }
+    }
+}
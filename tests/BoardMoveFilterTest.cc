@@ -0,0 +1,52 @@
+#include "BoardTestBase.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const int32_t occupancies = 2000;
+}
+
+class BoardMoveFilterTest : public BoardTestBase
+{
+public:
+    BoardMoveFilterTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardMoveFilterTest, avx2_filter_matches_scalar_filter )
+{
+    if ( not Board::has_avx2_filter( ) )
+    {
+        GTEST_SKIP( ) << "No AVX2 support";
+    }
+
+    std::mt19937_64 engine( 37u );
+    for ( int32_t i = 0; i < occupancies; ++i )
+    {
+        //! Sparse, even and crowded boards, the jumps need their middle field filled
+        uint64_t filled = engine( );
+        if ( i % 3 == 0 )
+        {
+            filled &= engine( );
+        }
+        else if ( i % 3 == 1 )
+        {
+            filled |= engine( );
+        }
+
+        for ( int32_t field = 0; field < NXN; ++field )
+        {
+            const int32_t remaining_moves = static_cast< int32_t >( engine( ) % 4 );
+            ASSERT_EQ(
+                Board::filter_field_candidates( field, filled, remaining_moves, false ),
+                Board::filter_field_candidates( field, filled, remaining_moves, true ) )
+                << "field " << field << " filled " << filled << " remaining moves "
+                << remaining_moves;
+        }
+    }
+}
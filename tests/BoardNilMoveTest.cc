@@ -24,7 +24,7 @@ TEST_F( BoardNilMoveTest, can_do_nil_move_when_team_is_done )
 
     int32_t count = 0;
     Move available_move = INVALID_MOVE;
-    for ( const auto move : board )
+    for ( auto iterator = board.begin( ); iterator.valid( ); iterator.next( ) )
     {
         ++count;
         if ( count > 1 )
@@ -32,7 +32,7 @@ TEST_F( BoardNilMoveTest, can_do_nil_move_when_team_is_done )
             break;
         }
 
-        available_move = move;
+        available_move = iterator.move( );
     }
 
     ASSERT_EQ( 1, count );
@@ -0,0 +1,136 @@
+#include "BoardTestBase.h"
+
+#include "../player/RandomNumberGenerator.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const int32_t max_turns = 40;
+}
+
+class BoardRandomMoveTest : public BoardTestBase
+{
+public:
+    BoardRandomMoveTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardRandomMoveTest, generators_do_not_share_state )
+{
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    Board board;
+    std::vector< Move > moves;
+    while ( board.get_turns( ) < max_turns )
+    {
+        moves.push_back( board.do_random_move( random ) );
+    }
+
+    //! Another game draws from its own generator between the moves of the replay
+    RandomNumberGenerator replay_random;
+    RandomNumberGenerator other_random;
+    Board replay_board;
+    Board other_board;
+    for ( const auto move : moves )
+    {
+        ASSERT_EQ( move, replay_board.do_random_move( replay_random ) );
+        if ( other_board.do_random_move( other_random ) == INVALID_MOVE )
+        {
+            other_board = Board( );
+        }
+    }
+}
+
+TEST_F( BoardRandomMoveTest, key_combines_hash_and_lock )
+{
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    Board board;
+    while ( board.get_turns( ) < max_turns )
+    {
+        const uint64_t key = board.get_hash( ) | static_cast< uint64_t >( board.get_lock( ) ) << 32;
+        ASSERT_EQ( key, board.get_key( ) );
+        board.do_random_move( random );
+    }
+}
+
+namespace
+{
+//! Plays the same seeded game with the specialized do_random_move and with the generic
+//! begin( ) and do_move path, the moves and the final boards must match
+void
+check_reference_playout( const Board& start, const uint32_t seed )
+{
+    RandomNumberGenerator random;
+    random.seed( seed );
+    RandomNumberGenerator reference_random;
+    reference_random.seed( seed );
+
+    Board board = start;
+    Board reference = start;
+    for ( int32_t moves = 0; moves < MAX_RUN_MOVES and not reference.end_game( )
+                             and reference.get_turns( ) < max_turns;
+          ++moves )
+    {
+        const auto reference_move = reference.begin( ).random_move( reference_random );
+        ASSERT_EQ( reference_move, board.do_random_move( random ) );
+        if ( reference_move == INVALID_MOVE )
+        {
+            break;
+        }
+
+        reference.do_move( reference_move );
+    }
+
+    ASSERT_EQ( reference.get_player( ), board.get_player( ) );
+    ASSERT_EQ( reference.get_turns( ), board.get_turns( ) );
+    ASSERT_EQ( reference.get_key( ), board.get_key( ) );
+    ASSERT_EQ( reference.get_score( Board::YELLOW ), board.get_score( Board::YELLOW ) );
+    for ( const auto player : {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED} )
+    {
+        ASSERT_EQ( reference.get_bitmask( player ), board.get_bitmask( player ) );
+        ASSERT_EQ( reference.get_index( player ), board.get_index( player ) );
+        ASSERT_EQ( reference.get_estimated_moves( player ), board.get_estimated_moves( player ) );
+        ASSERT_EQ( reference.is_done( player ), board.is_done( player ) );
+    }
+}
+}
+
+TEST_F( BoardRandomMoveTest, specialized_moves_match_generic_moves )
+{
+    Board::pre_compute( );
+
+    for ( uint32_t seed = 1u; seed <= 20u; ++seed )
+    {
+        check_reference_playout( Board( ), seed );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "seed " << seed;
+    }
+}
+
+TEST_F( BoardRandomMoveTest, specialized_solo_moves_match_generic_moves )
+{
+    Board::pre_compute( );
+
+    for ( uint32_t seed = 1u; seed <= 20u; ++seed )
+    {
+        //! Solo games of every player, from the start and from the middle of a team game
+        RandomNumberGenerator random;
+        random.seed( seed );
+        Board board;
+        for ( uint32_t move = 0u; move < seed % 4u * 8u; ++move )
+        {
+            board.do_random_move( random );
+        }
+
+        board.enable_solo_mode( board.get_player( ) );
+        check_reference_playout( board, seed );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "seed " << seed;
+    }
+}
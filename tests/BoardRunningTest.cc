@@ -0,0 +1,238 @@
+#include "BoardTestBase.h"
+
+#include <numeric>
+
+#include "../player/RandomNumberGenerator.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const Board::Player players[] = {Board::YELLOW, Board::BLACK, Board::WHITE, Board::RED};
+
+//! Target corner of each player
+const int32_t corners[] = {7, 63, 0, 56};
+
+//! Before this turn no player is running
+const int32_t running_turns = 24;
+
+const int32_t positions = 2000;
+
+//! Scans the bounding box of the stones and the corner of the player, or of the teammate once
+//! the player is done, for stones of the other players
+bool
+is_running_reference( const Board& board, const Board::Player p )
+{
+    if ( board.get_turns( ) < running_turns )
+    {
+        return false;
+    }
+
+    const auto player = board.is_done( p ) ? Board::get_teammate( p ) : p;
+    int32_t min_row = corners[ player ] / N;
+    int32_t max_row = min_row;
+    int32_t min_column = corners[ player ] % N;
+    int32_t max_column = min_column;
+    for ( int32_t field = 0; field < NXN; ++field )
+    {
+        if ( board.player_occupies_field( player, field ) )
+        {
+            min_row = std::min( min_row, field / N );
+            max_row = std::max( max_row, field / N );
+            min_column = std::min( min_column, field % N );
+            max_column = std::max( max_column, field % N );
+        }
+    }
+
+    for ( int32_t row = min_row; row <= max_row; ++row )
+    {
+        for ( int32_t column = min_column; column <= max_column; ++column )
+        {
+            const int32_t field = N * row + column;
+            if ( not board.is_empty( field ) and not board.player_occupies_field( player, field ) )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//! The nil moves only pass the turns, the stones stay where they are
+Board
+get_board( const uint64_t bitmasks[ 4 ], const int32_t turns = running_turns )
+{
+    Board board{Board::YELLOW, bitmasks};
+    while ( board.get_turns( ) < turns )
+    {
+        board.do_move( NIL_MOVE );
+    }
+
+    return board;
+}
+
+//! Four stones for each player on distinct fields picked among the given ones
+void
+get_random_bitmasks( std::vector< int32_t > fields,
+                     std::mt19937& engine,
+                     uint64_t bitmasks[ 4 ] )
+{
+    std::shuffle( fields.begin( ), fields.end( ), engine );
+    for ( int32_t p = 0; p < 4; ++p )
+    {
+        bitmasks[ p ] = 0ull;
+        for ( int32_t k = 0; k < 4; ++k )
+        {
+            bitmasks[ p ] |= 1ull << fields[ 4 * p + k ];
+        }
+    }
+}
+
+//! Four stones for each player in the five rows and columns next to its corner, the areas
+//! overlap so that the boxes are crossed by the other players now and then
+void
+get_corner_bitmasks( std::mt19937& engine, uint64_t bitmasks[ 4 ] )
+{
+    uint64_t filled = 0ull;
+    for ( int32_t p = 0; p < 4; ++p )
+    {
+        std::vector< int32_t > fields;
+        for ( int32_t field = 0; field < NXN; ++field )
+        {
+            if ( std::abs( field / N - corners[ p ] / N ) < 5
+                 and std::abs( field % N - corners[ p ] % N ) < 5
+                 and ( filled & 1ull << field ) == 0ull )
+            {
+                fields.push_back( field );
+            }
+        }
+
+        std::shuffle( fields.begin( ), fields.end( ), engine );
+        bitmasks[ p ] = 0ull;
+        for ( int32_t k = 0; k < 4; ++k )
+        {
+            bitmasks[ p ] |= 1ull << fields[ k ];
+        }
+        filled |= bitmasks[ p ];
+    }
+}
+
+void
+check_running( const Board& board )
+{
+    bool all_running = board.get_turns( ) >= running_turns;
+    for ( const auto player : players )
+    {
+        const bool running = is_running_reference( board, player );
+        ASSERT_EQ( running, board.is_running( player ) )
+            << "player " << static_cast< int32_t >( player ) << " turns " << board.get_turns( );
+        all_running = all_running and running;
+    }
+
+    ASSERT_EQ( all_running, board.is_running( ) );
+}
+}
+
+class BoardRunningTest : public BoardTestBase
+{
+public:
+    BoardRunningTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardRunningTest, random_positions_match_scan )
+{
+    Board::pre_compute( );
+
+    std::vector< int32_t > fields( NXN );
+    std::iota( fields.begin( ), fields.end( ), 0 );
+
+    std::mt19937 engine( 30u );
+    uint64_t bitmasks[ 4 ];
+    for ( int32_t i = 0; i < positions; ++i )
+    {
+        get_random_bitmasks( fields, engine, bitmasks );
+        check_running( get_board( bitmasks ) );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "position " << i;
+
+        get_corner_bitmasks( engine, bitmasks );
+        check_running( get_board( bitmasks ) );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "corner position " << i;
+    }
+}
+
+TEST_F( BoardRunningTest, border_positions_match_scan )
+{
+    Board::pre_compute( );
+
+    //! Only the first and last rows and columns, the boxes touch the edges of the board
+    std::vector< int32_t > fields;
+    for ( int32_t field = 0; field < NXN; ++field )
+    {
+        if ( field / N == 0 or field / N == N - 1 or field % N == 0 or field % N == N - 1 )
+        {
+            fields.push_back( field );
+        }
+    }
+
+    std::mt19937 engine( 30u );
+    uint64_t bitmasks[ 4 ];
+    for ( int32_t i = 0; i < positions; ++i )
+    {
+        get_random_bitmasks( fields, engine, bitmasks );
+        check_running( get_board( bitmasks ) );
+        ASSERT_FALSE( HasFatalFailure( ) ) << "position " << i;
+    }
+}
+
+TEST_F( BoardRunningTest, home_positions_match_scan )
+{
+    Board::pre_compute( );
+
+    //! Every player on its target, the done players are judged on their teammate's stones
+    uint64_t bitmasks[ 4 ];
+    for ( const auto player : players )
+    {
+        bitmasks[ player ] = Board::get_start( static_cast< Board::Player >( 3 - player ) );
+    }
+
+    const auto home = get_board( bitmasks );
+    for ( const auto player : players )
+    {
+        ASSERT_TRUE( home.is_done( player ) );
+    }
+    check_running( home );
+    ASSERT_TRUE( home.is_running( ) );
+
+    //! On the start fields, before and after the running turns
+    for ( const auto player : players )
+    {
+        bitmasks[ player ] = Board::get_start( player );
+    }
+
+    check_running( get_board( bitmasks, 0 ) );
+    check_running( get_board( bitmasks, running_turns - 1 ) );
+    check_running( get_board( bitmasks ) );
+}
+
+TEST_F( BoardRunningTest, game_positions_match_scan )
+{
+    Board::pre_compute( );
+
+    RandomNumberGenerator random;
+    random.seed( 30u );
+    for ( int32_t game = 0; game < 20; ++game )
+    {
+        Board board;
+        while ( not board.end_game( ) and board.do_random_move( random ) != INVALID_MOVE )
+        {
+            check_running( board );
+            ASSERT_FALSE( HasFatalFailure( ) ) << "game " << game;
+        }
+    }
+}
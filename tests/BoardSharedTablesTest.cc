@@ -0,0 +1,59 @@
+#include "BoardTestBase.h"
+
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+//! Only used by this test, so no other test builds its context or its segment
+const std::string layout = std::string( 56, '0' ) + std::string( 3, '1' ) + std::string( 53, '0' );
+
+//! Set in the process started to attach to the tables built by the test
+const char* const ATTACHING = "LESS_TEST_ATTACHING";
+}
+
+class BoardSharedTablesTest : public BoardTestBase
+{
+public:
+    BoardSharedTablesTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardSharedTablesTest, attached_tables_are_settled )
+{
+    if ( std::getenv( ATTACHING ) != nullptr )
+    {
+        ASSERT_TRUE( Board::share_tables( ) );
+        ASSERT_TRUE( Board::has_complete_tables( ) );
+        for ( const auto player : {YELLOW, BLACK, WHITE, RED} )
+        {
+            ASSERT_TRUE( Board::is_table_settled( player ) );
+        }
+
+        return;
+    }
+
+    //! A segment left by an interrupted run would be attached instead of built
+    Board::unshare_tables( );
+    ASSERT_TRUE( Board::share_tables( ) );
+
+    //! The contexts are per process: the attaching side runs this test in a new process
+    const pid_t pid = fork( );
+    if ( pid == 0 )
+    {
+        setenv( ATTACHING, "1", 1 );
+        execl( "/proc/self/exe", "PlayerTests",
+               "--gtest_filter=BoardSharedTablesTest.attached_tables_are_settled", nullptr );
+        _exit( 127 );
+    }
+
+    int status = 0;
+    ASSERT_EQ( pid, waitpid( pid, &status, 0 ) );
+    Board::unshare_tables( );
+
+    ASSERT_TRUE( WIFEXITED( status ) );
+    ASSERT_EQ( 0, WEXITSTATUS( status ) );
+}
@@ -0,0 +1,97 @@
+#include "BoardTestBase.h"
+
+#include "../player/CombinationIndex.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+const std::vector< uint64_t > bitmasks{1ull << 48 | 1ull << 49 | 1ull << 56 | 1ull << 57,
+                                       1ull << 0 | 1ull << 1 | 1ull << 8 | 1ull << 9,
+                                       1ull << 54 | 1ull << 55 | 1ull << 62 | 1ull << 63,
+                                       1ull << 6 | 1ull << 7 | 1ull << 14 | 1ull << 22,
+                                       1ull << 3 | 1ull << 20 | 1ull << 21 | 1ull << 40,
+                                       1ull << 0 | 1ull << 27 | 1ull << 36 | 1ull << 63};
+}
+
+using ::testing::WithParamInterface;
+using ::testing::ValuesIn;
+
+class BoardStoreIndexTest : public BoardTestBase, public WithParamInterface< uint64_t >
+{
+public:
+    BoardStoreIndexTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_P( BoardStoreIndexTest, index_is_updated_on_swap )
+{
+    const uint64_t bitmask = GetParam( );
+
+    for ( int32_t from = 0; from < NXN; ++from )
+    {
+        if ( ( bitmask & ( 1ull << from ) ) == 0ull )
+        {
+            continue;
+        }
+
+        for ( int32_t to = 0; to < NXN; ++to )
+        {
+            if ( ( bitmask & ( 1ull << to ) ) != 0ull )
+            {
+                continue;
+            }
+
+            Board board{Board::YELLOW, bitmask};
+            board.swap( from, to );
+
+            const uint64_t moved_bitmask = board.get_bitmask( Board::YELLOW );
+            ASSERT_EQ( bitmask ^ ( 1ull << from ) ^ ( 1ull << to ), moved_bitmask );
+            ASSERT_EQ( compute_index( moved_bitmask ), board.get_index( Board::YELLOW ) );
+        }
+    }
+}
+
+TEST_P( BoardStoreIndexTest, index_is_decoded )
+{
+    const uint64_t bitmask = GetParam( );
+
+    ASSERT_EQ( bitmask, CombinationIndex::get_bitmask( compute_index( bitmask ) ) );
+}
+
+TEST_P( BoardStoreIndexTest, variants_agree )
+{
+    const uint64_t bitmask = GetParam( );
+
+    ASSERT_EQ( compute_index( bitmask ), CombinationIndex::get_with_ffs( bitmask ) );
+    ASSERT_EQ( compute_index( bitmask ), CombinationIndex::get_with_bytes( bitmask ) );
+    if ( CombinationIndex::has_bmi2( ) )
+    {
+        ASSERT_EQ( compute_index( bitmask ), CombinationIndex::get_with_bmi2( bitmask ) );
+    }
+}
+
+INSTANTIATE_TEST_CASE_P( Bitmasks, BoardStoreIndexTest, ValuesIn( bitmasks ) );
+
+class BoardStoreEmptyIndexTest : public BoardTestBase
+{
+public:
+    BoardStoreEmptyIndexTest( )
+        : BoardTestBase( layout )
+    {
+    }
+};
+
+TEST_F( BoardStoreEmptyIndexTest, empty_bitmask_has_index_zero )
+{
+    ASSERT_EQ( 0, CombinationIndex::get_with_ffs( 0ull ) );
+    ASSERT_EQ( 0, CombinationIndex::get_with_bytes( 0ull ) );
+    if ( CombinationIndex::has_bmi2( ) )
+    {
+        ASSERT_EQ( 0, CombinationIndex::get_with_bmi2( 0ull ) );
+    }
+}
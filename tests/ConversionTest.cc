@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include "../player/Common.h"
+
+#include "../player/Conversion.h"
+
+TEST( ConversionTest, actions_of_the_protocol_are_valid )
+{
+    ASSERT_TRUE( Conversion::is_valid_action( "Nil" ) );
+    ASSERT_TRUE( Conversion::is_valid_action( "h1f1" ) );
+    ASSERT_TRUE( Conversion::is_valid_action( "h1f1:g1e1:h2f2" ) );
+}
+
+TEST( ConversionTest, malformed_actions_are_invalid )
+{
+    ASSERT_FALSE( Conversion::is_valid_action( "" ) );
+    ASSERT_FALSE( Conversion::is_valid_action( "h1f" ) );
+    ASSERT_FALSE( Conversion::is_valid_action( "i1f1" ) );
+    ASSERT_FALSE( Conversion::is_valid_action( "h1f9" ) );
+    ASSERT_FALSE( Conversion::is_valid_action( "h1f1:" ) );
+    ASSERT_FALSE( Conversion::is_valid_action( "h1f1::g1e1" ) );
+}
+
+TEST( ConversionTest, over_long_actions_are_invalid_and_bounded )
+{
+    const std::string over_long( "h1f1:g1e1:h2f2:g2e2" );
+    ASSERT_FALSE( Conversion::is_valid_action( over_long ) );
+
+    //! The moves past the capacity are dropped instead of overflowing the action
+    const auto action = Conversion::string_to_action( over_long );
+    ASSERT_EQ( MAX_ACTION_MOVES, action.size( ) );
+    ASSERT_EQ( "h1f1:g1e1:h2f2", Conversion::action_to_string( action ) );
+}
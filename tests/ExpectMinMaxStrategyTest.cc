@@ -0,0 +1,164 @@
+#include "BoardTestBase.h"
+
+#include "../player/ExpectMinMaxStrategy.h"
+#include "../player/RandomNumberGenerator.h"
+#include "../player/SearchContext.h"
+#include "../player/TranspositionTable.h"
+
+namespace
+{
+const std::string layout(
+    "01000000100000200001010012110001100000100100001010000000000100011010100010"
+    "01000010000000000000100000101011001010" );
+
+//! The odd helpers start one depth ahead, the even ones at the first depth
+const int32_t helpers = 2;
+const int32_t max_turns = 4;
+//! Depth searched before the stopped helper, whose moves then come from the table as in the
+//! later turns of a game
+const int32_t searched_depth = 3;
+//! The table keeps floats
+const double tolerance = 1e-3;
+//! Enough for the searches from an empty table, much faster to allocate than a game table
+const size_t value_table_megabytes = 16;
+}
+
+class ExpectMinMaxStrategyTest : public BoardTestBase
+{
+public:
+    ExpectMinMaxStrategyTest( )
+        : BoardTestBase( layout )
+    {
+    }
+
+    //! Deepens as a helper does, up to the depth only and never stopped
+    static void
+    search_to_depth( ExpectMinMaxStrategy& strategy,
+                     const Board& board,
+                     const int32_t helper,
+                     const int32_t depth )
+    {
+        strategy.m_helper = helper;
+        for ( int32_t d = 1 + helper % 2; d <= depth; ++d )
+        {
+            strategy.init_search( );
+            strategy.search( board, -OO, +OO, d );
+            const auto& pv = strategy.m_pv[ 0 ];
+            strategy.m_line.assign( pv, pv + strategy.m_pv_length[ 0 ] );
+        }
+    }
+
+    //! Value of a full search of the position from an empty table
+    static double
+    search_value( const Board& board, const Board::Player player, const int32_t depth )
+    {
+        SearchContext context;
+        context.transposition_table.reset( new TranspositionTable( value_table_megabytes ) );
+        ExpectMinMaxStrategy strategy( context, player );
+        strategy.init_search( );
+        return strategy.search( board, -OO, +OO, depth );
+    }
+
+    static bool
+    is_aborted( const ExpectMinMaxStrategy& strategy )
+    {
+        return strategy.m_aborted;
+    }
+
+    static uint64_t
+    get_key( const ExpectMinMaxStrategy& strategy, const Board& board )
+    {
+        return board.get_key( ) ^ strategy.m_key_salt;
+    }
+
+    //! Entries of the node and of the nodes below it, by key. The walk stops at the nodes
+    //! without entry, which were never searched
+    static void
+    get_entries( const ExpectMinMaxStrategy& strategy,
+                 const Board& node,
+                 std::map< uint64_t, std::pair< Board, Entry > >& entries )
+    {
+        Entry entry;
+        const uint64_t key = get_key( strategy, node );
+        if ( not strategy.m_transposition_table.find( key, entry )
+             or not entries.emplace( key, std::make_pair( node, entry ) ).second )
+        {
+            return;
+        }
+
+        if ( node.end_game( ) )
+        {
+            return;
+        }
+
+        for ( auto iterator = node.begin( ); iterator.valid( ); iterator.next( ) )
+        {
+            Board child = node;
+            child.do_move( iterator.move( ) );
+            get_entries( strategy, child, entries );
+        }
+    }
+
+    //! The entry must bound the value of the node searched from an empty table at its depth
+    static void
+    check_entry( const Board& node, const Board::Player player, const Entry& entry )
+    {
+        const double value = search_value( node, player, entry.depth );
+        if ( entry.type != Entry::UPPER )
+        {
+            ASSERT_GE( value, entry.value - tolerance );
+        }
+
+        if ( entry.type != Entry::LOWER )
+        {
+            ASSERT_LE( value, entry.value + tolerance );
+        }
+    }
+};
+
+TEST_F( ExpectMinMaxStrategyTest, stopped_helper_stores_no_aborted_values )
+{
+    Board::pre_compute( );
+
+    //! Stopped before they start, the helpers abort deterministically on their first deadline
+    //! check, in the first depth searching enough nodes
+    const std::atomic< bool > stop( true );
+    RandomNumberGenerator random;
+    Board board;
+    while ( board.get_turns( ) < max_turns )
+    {
+        for ( int32_t helper = 1; helper <= helpers; ++helper )
+        {
+            const auto player = board.get_player( );
+            SearchContext context;
+            ExpectMinMaxStrategy searched( context, player );
+            search_to_depth( searched, board, helper, searched_depth );
+            std::map< uint64_t, std::pair< Board, Entry > > searched_entries;
+            get_entries( searched, board, searched_entries );
+
+            ExpectMinMaxStrategy strategy( context, player );
+            strategy.search_as_helper( board, helper, stop );
+            ASSERT_TRUE( is_aborted( strategy ) );
+
+            //! The nodes of the aborted line keep values of their completed searches only: the
+            //! line is not known, so every entry written by the stopped helper is checked
+            std::map< uint64_t, std::pair< Board, Entry > > entries;
+            get_entries( strategy, board, entries );
+            for ( const auto& keyed_entry : entries )
+            {
+                const auto& entry = keyed_entry.second.second;
+                const auto searched = searched_entries.find( keyed_entry.first );
+                if ( searched == searched_entries.end( )
+                     or searched->second.second.depth != entry.depth
+                     or searched->second.second.type != entry.type
+                     or searched->second.second.value != entry.value )
+                {
+                    check_entry( keyed_entry.second.first, player, entry );
+                    ASSERT_FALSE( HasFatalFailure( ) ) << "helper " << helper;
+                }
+            }
+        }
+
+        board.do_random_move( random );
+    }
+}
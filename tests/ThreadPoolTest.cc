@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "../player/Common.h"
+
+#include "../player/ThreadPool.h"
+
+#include <unistd.h>
+
+TEST( ThreadPoolTest, wait_returns_once_the_group_is_done )
+{
+    ThreadPool pool( 3, false );
+    ThreadPool::Group group;
+    std::atomic< int32_t > count( 0 );
+    for ( int32_t i = 0; i < 1000; ++i )
+    {
+        pool.submit( [&count]( ) { ++count; }, group );
+    }
+
+    pool.wait( group );
+    ASSERT_TRUE( group.done( ) );
+    ASSERT_EQ( 1000, count.load( ) );
+}
+
+TEST( ThreadPoolTest, tasks_may_wait_for_their_own_tasks )
+{
+    //! A single worker has to run the nested tasks while it waits for them
+    ThreadPool pool( 1, false );
+    ThreadPool::Group group;
+    std::atomic< int32_t > count( 0 );
+    for ( int32_t i = 0; i < 8; ++i )
+    {
+        pool.submit(
+            [&pool, &count]( ) {
+                ThreadPool::Group nested;
+                for ( int32_t j = 0; j < 8; ++j )
+                {
+                    pool.submit( [&count]( ) { ++count; }, nested );
+                }
+
+                pool.wait( nested );
+            },
+            group );
+    }
+
+    pool.wait( group );
+    ASSERT_EQ( 64, count.load( ) );
+}
+
+TEST( ThreadPoolTest, utilization_counts_the_tasks_of_the_workers )
+{
+    uint64_t tasks = 0;
+    {
+        ThreadPool pool( 2, false );
+        ThreadPool::Group group;
+        for ( int32_t i = 0; i < 100; ++i )
+        {
+            pool.submit( []( ) {}, group );
+        }
+
+        //! Not helping, the workers run all of them
+        while ( not group.done( ) )
+        {
+            usleep( 100 );
+        }
+
+        for ( int32_t worker = 0; worker < pool.get_workers_count( ); ++worker )
+        {
+            tasks += pool.get_utilization( worker ).tasks;
+        }
+    }
+
+    ASSERT_EQ( 100u, tasks );
+}
+
+TEST( ThreadPoolTest, wait_only_runs_the_tasks_of_its_group )
+{
+    //! The single worker is held by a blocker, the tasks queued behind it are left to the waiter
+    ThreadPool pool( 1, false );
+    ThreadPool::Group blocker_group;
+    std::atomic< bool > started( false );
+    std::atomic< bool > released( false );
+    pool.submit(
+        [&started, &released]( ) {
+            started = true;
+            while ( not released )
+            {
+                usleep( 100 );
+            }
+        },
+        blocker_group );
+
+    while ( not started )
+    {
+        usleep( 100 );
+    }
+
+    ThreadPool::Group long_group;
+    pool.submit( []( ) { usleep( 100000 ); }, long_group );
+
+    ThreadPool::Group short_group;
+    pool.submit( []( ) {}, short_group );
+
+    pool.wait( short_group );
+    //! Only the waiter could have run the long task
+    const bool long_done = long_group.done( );
+
+    released = true;
+    pool.wait( blocker_group );
+    pool.wait( long_group );
+    ASSERT_FALSE( long_done );
+}
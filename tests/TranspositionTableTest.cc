@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "../player/Common.h"
+
+#include "../player/TranspositionTable.h"
+
+namespace
+{
+//! Keys of the same bucket whatever the size of the table
+uint64_t
+get_key( const uint64_t index )
+{
+    return index << 40;
+}
+}
+
+TEST( TranspositionTableTest, size_is_a_power_of_two_within_the_budget )
+{
+    TranspositionTable table( 3 );
+    const size_t size = table.get_size( );
+    ASSERT_EQ( 0u, size & ( size - 1 ) );
+    ASSERT_EQ( size_t( 2 ) << 20, size * sizeof( Entry ) );
+}
+
+TEST( TranspositionTableTest, found_entries_keep_their_values )
+{
+    TranspositionTable table( 1 );
+    Entry entry;
+    ASSERT_FALSE( table.find( 42u, entry ) );
+
+    table.store( 42u, 3, Entry::LOWER, 0.25, CREATE_MOVE( 1, 2 ) );
+    ASSERT_TRUE( table.find( 42u, entry ) );
+    ASSERT_EQ( 3, entry.depth );
+    ASSERT_EQ( Entry::LOWER, entry.type );
+    ASSERT_EQ( 0.25f, entry.value );
+    ASSERT_EQ( CREATE_MOVE( 1, 2 ), entry.move );
+
+    //! A bound without a move keeps the move of the position
+    table.store( 42u, 4, Entry::UPPER, -0.5, INVALID_MOVE );
+    ASSERT_TRUE( table.find( 42u, entry ) );
+    ASSERT_EQ( 4, entry.depth );
+    ASSERT_EQ( CREATE_MOVE( 1, 2 ), entry.move );
+}
+
+TEST( TranspositionTableTest, replaces_the_oldest_then_the_shallowest_entries )
+{
+    TranspositionTable table( 1 );
+    table.store( get_key( 1 ), 5, Entry::EXACT, 0.0, INVALID_MOVE );
+    table.new_generation( );
+    for ( uint64_t index = 2; index <= TranspositionTable::BUCKET_ENTRIES; ++index )
+    {
+        table.store( get_key( index ), 6 - index, Entry::EXACT, 0.0, INVALID_MOVE );
+    }
+
+    //! The deep entry of the previous search goes first
+    Entry entry;
+    table.store( get_key( 10 ), 1, Entry::EXACT, 0.0, INVALID_MOVE );
+    ASSERT_FALSE( table.find( get_key( 1 ), entry ) );
+    ASSERT_TRUE( table.find( get_key( 10 ), entry ) );
+
+    //! Then the shallowest one of the current search
+    table.store( get_key( 11 ), 3, Entry::EXACT, 0.0, INVALID_MOVE );
+    ASSERT_FALSE( table.find( get_key( 10 ), entry ) );
+    for ( uint64_t index = 2; index <= TranspositionTable::BUCKET_ENTRIES; ++index )
+    {
+        ASSERT_TRUE( table.find( get_key( index ), entry ) );
+    }
+}
+
+TEST( TranspositionTableTest, concurrent_stores_never_return_torn_entries )
+{
+    //! Few buckets, so the threads keep overwriting the slots read by the others
+    TranspositionTable table( 0 );
+    const uint64_t keys = 64;
+    auto store_and_find = [&table, keys]( const uint64_t first ) {
+        Entry entry;
+        for ( uint64_t i = 0; i < 200000; ++i )
+        {
+            const uint64_t key = ( first + i ) % keys + 1;
+            table.store( key, static_cast< int32_t >( key ), Entry::EXACT, key,
+                         static_cast< Move >( key ) );
+            if ( table.find( ( key * 7 ) % keys + 1, entry ) )
+            {
+                ASSERT_EQ( entry.key, static_cast< uint64_t >( entry.depth ) );
+                ASSERT_EQ( entry.key, static_cast< uint64_t >( entry.value ) );
+                ASSERT_EQ( entry.key, static_cast< uint64_t >( entry.move ) );
+            }
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for ( uint64_t thread = 0; thread < 4; ++thread )
+    {
+        threads.emplace_back( store_and_find, 13 * thread );
+    }
+
+    for ( auto& thread : threads )
+    {
+        thread.join( );
+    }
+}